@@ -1,7 +1,7 @@
 #include "Editor.hh"
 #include <thread>
+#include <tick/tickEnemy.hh>
 #include <tick/tickSwitch.hh>
-#include <tick/tickDoor.hh>
 
 Editor::Editor(Graphics* graphics, const std::string & level)
     : m_graphics(graphics)
@@ -44,6 +44,7 @@ Editor::Editor(Graphics* graphics, const std::string & level)
         m_gameState->level = std::make_shared<Level>(5, 5, point_t(0, 0), 20.0f);
     }
     m_gameState->tick = 0;
+    m_gameState->buildSignalGraph();
 
     float startCamera = m_gameState->level->scale * 0.5 * std::min(m_gameState->level->width, m_gameState->level->height);
 
@@ -71,15 +72,15 @@ void Editor::mainLoop()
         //Update certain objects
         for(Switch * sw : m_gameState->switches())
         {
-            sw->nextState = sw->state;
+            sw->prepareNextState();
             tick::tickSwitch(m_gameState.get(), sw);
-            sw->state = sw->nextState;
+            sw->applyNextState();
         }
-        for(Door * door : m_gameState->doors())
+        m_gameState->signalGraph().updateLive();
+        //Only drawn as part of the debug overlay
+        if(m_graphics->shouldDrawDebug)
         {
-            door->nextState = door->state;
-            tick::tickDoor(m_gameState.get(), door);
-            door->state = door->nextState;
+            tick::buildThreatMap(m_gameState.get());
         }
 
         m_graphics->draw(m_gameState.get(), m_cameraCenter);
@@ -98,8 +99,8 @@ void Editor::handleInputs()
     for(auto pair: m_gameState->objects())
     {
         GameObject * obj = pair.second.get();
-        float dist = math_util::dist(obj->state.pos, m_gameState->mousePos);
-        if(dist < obj->size.x && dist < minDist)
+        float dist = math_util::dist(obj->state().pos, m_gameState->mousePos);
+        if(dist < obj->size().x && dist < minDist)
         {
             highlightedObject = obj;
             minDist = dist;
@@ -131,17 +132,17 @@ void Editor::handleInputs()
     {
         if(m_controls.drag)
         {
-            m_state->draggedObject->state.pos = m_gameState->mousePos;
+            m_state->draggedObject->state().pos = m_gameState->mousePos;
         }
         else
         {
-            m_state->draggedObject->state.pos = placement(m_gameState->mousePos);
+            m_state->draggedObject->state().pos = placement(m_gameState->mousePos);
 
             if(m_state->draggedObject->type() == GameObject::ENEMY)
             {
                 Enemy * enemy = static_cast<Enemy*>(m_state->draggedObject);
-                enemy->patrolPoints[0].x = enemy->state.pos.x;
-                enemy->patrolPoints[0].y = enemy->state.pos.y;
+                enemy->definition->patrolPoints[0].x = enemy->state().pos.x;
+                enemy->definition->patrolPoints[0].y = enemy->state().pos.y;
             }
 
             m_state->isDragging = false;
@@ -178,7 +179,7 @@ void Editor::handleInputs()
                 {
                     if(x >= 0 && x < m_gameState->level->width && y >= 0 && y < m_gameState->level->height)
                     {
-                        m_gameState->level->tiles[x][y].type = m_state->paintType;
+                        m_gameState->level->setTile(x, y, m_state->paintType);
                     }
                 }
             }
@@ -192,7 +193,7 @@ void Editor::handleInputs()
         if(levelCoords.x >= 0 && levelCoords.x < m_gameState->level->width && levelCoords.y >= 0 && levelCoords.y < m_gameState->level->height)
         {
             m_state->isPainting = true;
-            m_state->paintType = m_gameState->level->tiles[levelCoords.x][levelCoords.y].type == Level::WALL ? Level::EMPTY : Level::WALL;
+            m_state->paintType = m_gameState->level->tile(levelCoords.x, levelCoords.y).type == Level::WALL ? Level::EMPTY : Level::WALL;
             m_state->paintOrigin = m_gameState->mousePos;
         }
     }
@@ -222,7 +223,8 @@ void Editor::handleInputs()
 
             //This could cause segfaults if this pointer is being dragged or something
             //but it's basically ok for the editor to have edge cases like that
-            m_gameState->objects().erase(highlightedObject->id);
+            //deleteObject also drops it from the per-type lists and the signal graph
+            m_gameState->deleteObject(highlightedObject->id);
             m_hasUnsavedChanges = true;
         }
     }
@@ -244,8 +246,9 @@ void Editor::handleInputs()
                     }
                     else
                     {
-                        std::erase_if(door->connectedSwitches, [sw](int id) { return id == sw->id; });
+                        std::erase_if(door->definition->connectedSwitches, [sw](int id) { return id == sw->id; });
                     }
+                    m_gameState->buildSignalGraph();
                     m_hasUnsavedChanges = true;
                 }
                 break;
@@ -257,11 +260,11 @@ void Editor::handleInputs()
                 //Reset patrol points when placing the first new patrol point
                 if(!m_state->hasConnected)
                 {
-                    enemy->patrolPoints.clear();
-                    enemy->patrolPoints.push_back(enemy->state.pos);
+                    enemy->definition->patrolPoints.clear();
+                    enemy->definition->patrolPoints.push_back(enemy->state().pos);
                 }
 
-                enemy->patrolPoints.push_back(placement(m_gameState->mousePos));
+                enemy->definition->patrolPoints.push_back(placement(m_gameState->mousePos));
                 m_hasUnsavedChanges = true;
                 std::cout << "Added patrol point " << m_gameState->mousePos.x << ", " << m_gameState->mousePos.y << std::endl;
                 break;
@@ -269,7 +272,7 @@ void Editor::handleInputs()
             case GameObject::SWITCH:
             {
                 Switch * sw = static_cast<Switch*>(m_state->selectedObject);
-                sw->state.aiState = sw->state.aiState == Switch::ON ? Switch::OFF : Switch::ON;
+                sw->state().aiState = sw->state().aiState == Switch::ON ? Switch::OFF : Switch::ON;
                 m_hasUnsavedChanges = true;
                 break;
             }
@@ -302,30 +305,19 @@ void Editor::handleInputs()
     //ROW/COLUMN MANAGEMENT
     if(m_controls.addRow)
     {
-        m_gameState->level->height++;
-        for(int x = 0; x < m_gameState->level->width; x++)
-        {
-            m_gameState->level->tiles[x].push_back(Level::Tile(Level::WALL));
-        }
-        m_gameState->level->setupNavMesh();
+        m_gameState->level->resize(m_gameState->level->width, m_gameState->level->height + 1);
         m_hasUnsavedChanges = true;
     }
     if(m_controls.addCol)
     {
-        m_gameState->level->width++;
-        m_gameState->level->tiles.push_back(std::vector<Level::Tile>(m_gameState->level->height, Level::Tile(Level::WALL)));
-        m_gameState->level->setupNavMesh();
+        m_gameState->level->resize(m_gameState->level->width + 1, m_gameState->level->height);
         m_hasUnsavedChanges = true;
     }
     if(m_controls.removeRow)
     {
         if(m_gameState->level->height > 1)
         {
-            m_gameState->level->height--;
-            for(int x = 0; x < m_gameState->level->width; x++)
-            {
-                m_gameState->level->tiles[x].pop_back();
-            }
+            m_gameState->level->resize(m_gameState->level->width, m_gameState->level->height - 1);
             m_hasUnsavedChanges = true;
         }
     }
@@ -333,8 +325,7 @@ void Editor::handleInputs()
     {
         if(m_gameState->level->width > 1)
         {
-            m_gameState->level->width--;
-            m_gameState->level->tiles.pop_back();
+            m_gameState->level->resize(m_gameState->level->width - 1, m_gameState->level->height);
             m_hasUnsavedChanges = true;
         }
     }
@@ -345,7 +336,7 @@ void Editor::handleInputs()
         if(m_gameState->players().size() == 0)
         {
             std::shared_ptr<Player> player = std::make_shared<Player>(m_gameState->nextID());
-            player->state.pos = placement(m_gameState->mousePos);
+            player->state().pos = placement(m_gameState->mousePos);
             m_gameState->addObject(player);
             m_hasUnsavedChanges = true;
             m_state->selectedObject = player.get();
@@ -358,8 +349,8 @@ void Editor::handleInputs()
     if(m_controls.placeEnemy)
     {
         std::shared_ptr<Enemy> enemy = std::make_shared<Enemy>(m_gameState->nextID());
-        enemy->state.pos = placement(m_gameState->mousePos);
-        enemy->patrolPoints.push_back(enemy->state.pos);
+        enemy->state().pos = placement(m_gameState->mousePos);
+        enemy->definition->patrolPoints.push_back(enemy->state().pos);
         m_gameState->addObject(enemy);
         m_hasUnsavedChanges = true;
         m_state->selectedObject = enemy.get();
@@ -367,7 +358,7 @@ void Editor::handleInputs()
     if(m_controls.placeTimeBox)
     {
         std::shared_ptr<TimeBox> tb = std::make_shared<TimeBox>(m_gameState->nextID());
-        tb->state.pos = placement(m_gameState->mousePos);
+        tb->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(tb);
         m_hasUnsavedChanges = true;
         m_state->selectedObject = tb.get();
@@ -375,23 +366,25 @@ void Editor::handleInputs()
     if(m_controls.placeSwitch)
     {
         std::shared_ptr<Switch> sw = std::make_shared<Switch>(m_gameState->nextID());
-        sw->state.pos = placement(m_gameState->mousePos);
+        sw->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(sw);
+        m_gameState->buildSignalGraph();
         m_hasUnsavedChanges = true;
         m_state->selectedObject = sw.get();
     }
     if(m_controls.placeDoor)
     {
         std::shared_ptr<Door> door = std::make_shared<Door>(m_gameState->nextID());
-        door->state.pos = placement(m_gameState->mousePos);
+        door->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(door);
+        m_gameState->buildSignalGraph();
         m_hasUnsavedChanges = true;
         m_state->selectedObject = door.get();
     }
     if(m_controls.placeCloset)
     {
         std::shared_ptr<Closet> closet = std::make_shared<Closet>(m_gameState->nextID());
-        closet->state.pos = placement(m_gameState->mousePos);
+        closet->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(closet);
         m_hasUnsavedChanges = true;
         m_state->selectedObject = closet.get();
@@ -399,7 +392,7 @@ void Editor::handleInputs()
     if(m_controls.placeTurnstile)
     {
         std::shared_ptr<Turnstile> turnstile = std::make_shared<Turnstile>(m_gameState->nextID());
-        turnstile->state.pos = placement(m_gameState->mousePos);
+        turnstile->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(turnstile);
         m_hasUnsavedChanges = true;
         m_state->selectedObject = turnstile.get();
@@ -407,7 +400,7 @@ void Editor::handleInputs()
     if(m_controls.placeSpikes)
     {
         std::shared_ptr<Spikes> spikes = std::make_shared<Spikes>(m_gameState->nextID(), 0, 0, 0);
-        spikes->state.pos = placement(m_gameState->mousePos);
+        spikes->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(spikes);
         m_hasUnsavedChanges = true;
         m_state->selectedObject = spikes.get();
@@ -415,7 +408,7 @@ void Editor::handleInputs()
     if(m_controls.placeObjective)
     {
         std::shared_ptr<Objective> obj = std::make_shared<Objective>(m_gameState->nextID());
-        obj->state.pos = placement(m_gameState->mousePos);
+        obj->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(obj);
         m_hasUnsavedChanges = true;
         m_state->selectedObject = obj.get();
@@ -423,7 +416,7 @@ void Editor::handleInputs()
     if(m_controls.placeKnife)
     {
         std::shared_ptr<Knife> knife = std::make_shared<Knife>(m_gameState->nextID());
-        knife->state.pos = placement(m_gameState->mousePos);
+        knife->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(knife);
         m_hasUnsavedChanges = true;
         m_state->selectedObject = knife.get();
@@ -431,7 +424,7 @@ void Editor::handleInputs()
     if(m_controls.placeGun)
     {
         std::shared_ptr<Gun> gun = std::make_shared<Gun>(m_gameState->nextID());
-        gun->state.pos = placement(m_gameState->mousePos);
+        gun->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(gun);
         m_hasUnsavedChanges = true;
         m_state->selectedObject = gun.get();
@@ -439,7 +432,7 @@ void Editor::handleInputs()
     if(m_controls.placeExit)
     {
         std::shared_ptr<Exit> exit = std::make_shared<Exit>(m_gameState->nextID());
-        exit->state.pos = placement(m_gameState->mousePos);
+        exit->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(exit);
         m_hasUnsavedChanges = true;
         m_state->selectedObject = exit.get();
@@ -447,7 +440,7 @@ void Editor::handleInputs()
     if(m_controls.placeAlarm)
     {
         std::shared_ptr<Alarm> alarm = std::make_shared<Alarm>(m_gameState->nextID());
-        alarm->state.pos = placement(m_gameState->mousePos);
+        alarm->state().pos = placement(m_gameState->mousePos);
         m_gameState->addObject(alarm);
         m_hasUnsavedChanges = true;
         m_state->selectedObject = alarm.get();
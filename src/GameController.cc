@@ -8,7 +8,12 @@ GameController::GameController(const std::string & levelPath, Graphics * graphic
     , m_gameState(new GameState())
 {
     jsonlevel::loadLevel(m_gameState.get(), levelPath);
+    //Visibility is only checked out to what enemies can see, plus a tile for the lines along their sides
+    float visibilityDistance = Enemy::VIEW_RADIUS + m_gameState->level->scale;
+    m_gameState->level->wallVisibility = WallVisibility::loadOrBuild(*m_gameState->level, visibilityDistance, jsonlevel::levelFilePath(levelPath, ".pvs"));
     m_gameState->obstructionGrid = search::createObstructionGrid(m_gameState.get());
+    m_gameState->classifyObjects();
+    m_gameState->buildSignalGraph();
     audio->init("silent_circuitry_mono.wav");
 }
 
@@ -123,7 +128,7 @@ bool GameController::mainLoop()
                     type = ADVANCE;
                 }
 
-                if(m_gameState->currentPlayer()->state.boxOccupied)
+                if(m_gameState->currentPlayer()->state().boxOccupied)
                 {
                     playbackSpeed = 2;
                 }
@@ -136,7 +141,7 @@ bool GameController::mainLoop()
 
         tick(type);
 
-        point_t cameraCenter = m_gameState->currentPlayer()->state.pos;
+        point_t cameraCenter = m_gameState->currentPlayer()->state().pos;
 
         if(win)
         {
@@ -160,6 +165,10 @@ bool GameController::mainLoop()
 
         if(tickCounter % playbackSpeed == 0)
         {
+            if(m_graphics->shouldDrawDebug)
+            {
+                tick::buildThreatMap(m_gameState.get());
+            }
             m_graphics->draw(m_gameState.get(), cameraCenter);
             if(m_controls.slowMotion)
             {
@@ -176,93 +185,128 @@ bool GameController::mainLoop()
     return true;
 }
 
-bool GameController::checkParadoxes()
+GameController::PlayerParadoxes GameController::findPlayerParadoxes(Player* player)
 {
-    //Note: current tick is still the tick we just finished doing
+    PlayerParadoxes paradoxes;
 
     //Player being hit by a bullet
-    for(Player* player : m_gameState->players())
+    for(Bullet* bullet : m_gameState->bullets())
     {
-        if(!player->activeAt(m_gameState->tick))
+        if(bullet->activeAt(m_gameState->tick) && player->isColliding(*bullet))
         {
-            continue;
+            paradoxes.shot = true;
+            break;
         }
+    }
 
-        for(Bullet* bullet : m_gameState->bullets())
+    //Player standing on spikes
+    for(Spikes* spikes : m_gameState->spikes())
+    {
+        if(spikes->activeAt(m_gameState->tick) && spikes->state().aiState == Spikes::UP && player->isColliding(*spikes))
         {
-            if(bullet->activeAt(m_gameState->tick) && player->isColliding(*bullet))
-            {
-                if(player->id == m_gameState->currentPlayer()->id)
-                {
-                    m_gameState->statusString = "YOU GOT SHOT";
-                }
-                else{
-                    m_gameState->statusString = "A PAST YOU GOT SHOT";
-                }
-                return true;
-            }
+            paradoxes.spiked = true;
+            break;
         }
     }
-    //Player standing on spikes
+
+    //Violation of observations
+    if(player->recorded)
+    {
+        paradoxes.observation = observation::checkObservations(m_gameState.get(), player, m_gameState->tick, false);
+    }
+
+    return paradoxes;
+}
+
+bool GameController::checkParadoxes()
+{
+    //Note: current tick is still the tick we just finished doing
+
+    //Every check only reads the state, so each player's checks can run in parallel.
+    //The serial version went through the players once per kind of paradox and stopped at the first one,
+    //so the results are looked through in the same order to report the same paradox.
+    std::vector<Player*> activePlayers;
     for(Player* player : m_gameState->players())
     {
-        if(!player->activeAt(m_gameState->tick))
+        if(player->activeAt(m_gameState->tick))
         {
-            continue;
+            activePlayers.push_back(player);
         }
+    }
+    std::vector<PlayerParadoxes> paradoxes(activePlayers.size());
+    JobSystem::get().parallelFor(activePlayers.size(), 1, [&](int i)
+    {
+        paradoxes[i] = findPlayerParadoxes(activePlayers[i]);
+    });
 
-        for(Spikes* spikes : m_gameState->spikes())
+    for(size_t i = 0; i < activePlayers.size(); i++)
+    {
+        if(paradoxes[i].shot)
         {
-            if(spikes->activeAt(m_gameState->tick) && spikes->state.aiState == Spikes::UP && player->isColliding(*spikes))
+            if(activePlayers[i]->id == m_gameState->currentPlayer()->id)
             {
-                if(player->id == m_gameState->currentPlayer()->id)
-                {
-                    m_gameState->statusString = "YOU GOT SPIKED";
-                }
-                else{
-                    m_gameState->statusString = "A PAST YOU GOT SPIKED";
-                }
-                return true;
+                m_gameState->statusString = "YOU GOT SHOT";
+            }
+            else{
+                m_gameState->statusString = "A PAST YOU GOT SHOT";
             }
+            return true;
         }
     }
-
-    //Violation of observations
-    for(Player* player : m_gameState->players())
+    for(size_t i = 0; i < activePlayers.size(); i++)
     {
-        if(!player->activeAt(m_gameState->tick))
+        if(paradoxes[i].spiked)
         {
-            continue;
-        }
-        if(player->recorded)
-        {
-            std::string result = observation::checkObservations(m_gameState.get(), player, m_gameState->tick);
-            if(result != "")
+            if(activePlayers[i]->id == m_gameState->currentPlayer()->id)
             {
-                m_gameState->statusString = result;
-                return true;
+                m_gameState->statusString = "YOU GOT SPIKED";
             }
+            else{
+                m_gameState->statusString = "A PAST YOU GOT SPIKED";
+            }
+            return true;
+        }
+    }
+    for(size_t i = 0; i < activePlayers.size(); i++)
+    {
+        if(paradoxes[i].observation != "")
+        {
+            //Run the check again to print what was expected, only for the violation being reported
+            observation::checkObservations(m_gameState.get(), activePlayers[i], m_gameState->tick, true);
+            m_gameState->statusString = paradoxes[i].observation;
+            return true;
         }
     }
 
     //Player seen by a backwards enemy
     //This is not a paradox that *needs* to exist to maintain the timeline, just an anti-frustration feature
     //Since being seen by an opposite-timed enemy is likely to result in paradoxes when you get back to this time later
-    for(Enemy* enemy : m_gameState->enemies())
+    //I *think* we only really need to check the current player
+    //Other players will get nailed by other paradoxes in time
+    Player * player = m_gameState->currentPlayer();
+    std::vector<Enemy*> & enemies = m_gameState->enemies();
+    //Rule out enemies facing the wrong way or too far off all at once, before any line of sight checks
+    math_util::ConeBatch viewBatch;
+    for(Enemy* enemy : enemies)
     {
-        if(!enemy->activeAt(m_gameState->tick))
-        {
-            continue;
-        }
+        tick::addToViewBatch(viewBatch, enemy, player->state().pos);
+    }
+    std::vector<math_util::BatchResult> inView;
+    math_util::coneTest(viewBatch, Enemy::VIEW_ANGLE / 2.0f, Enemy::VIEW_RADIUS, inView);
 
-        //I *think* we only really need to check the current player
-        //Other players will get nailed by other paradoxes in time
-        Player * player = m_gameState->currentPlayer();
-        if(player->backwards != enemy->backwards
-           && tick::playerVisibleToEnemy(m_gameState.get(), player, enemy))
+    std::vector<char> seen(enemies.size(), false);
+    JobSystem::get().parallelFor(enemies.size(), ENEMIES_PER_JOB, [&](int i)
+    {
+        Enemy* enemy = enemies[i];
+        seen[i] = enemy->activeAt(m_gameState->tick)
+            && player->backwards != enemy->backwards
+            && tick::playerVisibleToEnemy(m_gameState.get(), player, enemy, inView[i]);
+    });
+    for(size_t i = 0; i < enemies.size(); i++)
+    {
+        if(seen[i])
         {
             m_gameState->statusString = "SEEN BY AN ENEMY WHILE BACKWARDS";
-            
             return true;
         }
     }
@@ -275,7 +319,7 @@ bool GameController::checkWin()
 {
     Player* player = m_gameState->currentPlayer();
 
-    if(!player->state.holdingObject || m_gameState->objects().at(player->state.heldObjectId)->type() != GameObject::OBJECTIVE)
+    if(!player->state().holdingObject || m_gameState->objects().at(player->state().heldObjectId)->type() != GameObject::OBJECTIVE)
     {
         return false;
     }
@@ -295,7 +339,9 @@ bool GameController::checkWin()
 void GameController::restoreState()
 {
     m_gameState->restoreState();
+    evaluateAnalyticObjects();
     m_gameState->doRewindCleanup();
+    m_gameState->alarmMembership.invalidate();
 }
 
 void GameController::popTimeline()
@@ -307,8 +353,19 @@ void GameController::popTimeline()
         throw std::runtime_error("Cannot pop the last timeline");
     }
 
+    //The popped timeline's own player will never be seen again, so neither will its visibility grids
+    for(Player* player : m_gameState->players())
+    {
+        if(m_gameState->timelines[m_gameState->timelines.size() - 2].objects.count(player->id) == 0)
+        {
+            m_gameState->visibilityCache.forgetPlayer(player->id);
+        }
+    }
+
     //Simply blow away the current timeline, which will return us to how things were before the push
     m_gameState->timelines.pop_back();
+    m_gameState->classifyObjects();
+    m_gameState->buildSignalGraph();
 
     restoreState();
 }
@@ -321,7 +378,7 @@ void GameController::pushTimeline()
 
     //Create a new player entity
     Player* oldPlayer = m_gameState->currentPlayer();
-    std::shared_ptr<Player> newPlayer(new Player(m_gameState->nextID(), oldPlayer));
+    std::shared_ptr<Player> newPlayer = makeObject<Player>(m_gameState->nextID(), oldPlayer);
     newPlayer->backwards = m_gameState->backwards();
     std::cout << "Creating new player with ID " << newPlayer->id << std::endl;
     oldPlayer->recorded = true;
@@ -343,61 +400,43 @@ void GameController::pushTimeline()
         newPlayer->beginning = m_gameState->tick;
         newPlayer->hasEnding = false;
     }
-    m_gameState->objects()[newPlayer->id] = newPlayer;
-    m_gameState->players().push_back(newPlayer.get());
 
     if(m_gameState->boxToEnter > -1)
     {
-        Container* box = dynamic_cast<Container*>(m_gameState->objects().at(m_gameState->boxToEnter).get());
+        Container* box = objectCast<Container>(m_gameState->objects().at(m_gameState->boxToEnter).get());
         box->activeOccupant = newPlayer->id;
 
-        newPlayer->state.boxOccupied = true;
-        newPlayer->state.attachedObjectId = box->id;
-        newPlayer->state.pos = box->state.pos;
-        newPlayer->state.visible = false;
+        newPlayer->state().boxOccupied = true;
+        newPlayer->state().attachedObjectId = box->id;
+        newPlayer->state().pos = box->state().pos;
+        newPlayer->state().visible = false;
     }
-    else if(oldPlayer->state.boxOccupied)
+    else if(oldPlayer->state().boxOccupied)
     {
-        Container* box = dynamic_cast<Container*>(m_gameState->objects().at(oldPlayer->state.attachedObjectId).get());
+        Container* box = objectCast<Container>(m_gameState->objects().at(oldPlayer->state().attachedObjectId).get());
 
-        newPlayer->state.boxOccupied = false;
-        newPlayer->state.attachedObjectId = -1;
-        newPlayer->state.visible = true;
-        //newPlayer->state.pos = math_util::moveInDirection(oldPlayer->state.pos, box->state.angle_deg, box->size.x);
+        newPlayer->state().boxOccupied = false;
+        newPlayer->state().attachedObjectId = -1;
+        newPlayer->state().visible = true;
+        //newPlayer->state().pos = math_util::moveInDirection(oldPlayer->state().pos, box->state().angle_deg, box->size().x);
 
         box->activeOccupant = -1;
     }
 
-    if(oldPlayer->state.holdingObject)
+    if(oldPlayer->state().holdingObject)
     {
         std::cout << "Holding object when timeline was pushed" << std::endl;
-        Throwable* oldHeldObject;
-        std::shared_ptr<Throwable> newHeldObject;
-
-        if(m_gameState->objects().at(oldPlayer->state.heldObjectId)->type() == GameObject::OBJECTIVE)
-        {
-            oldHeldObject = dynamic_cast<Objective*>(m_gameState->objects().at(oldPlayer->state.heldObjectId).get());
-            newHeldObject = std::make_shared<Objective>(m_gameState->nextID(), dynamic_cast<Objective*>(m_gameState->objects().at(oldPlayer->state.heldObjectId).get()));
-        }
-        else if(m_gameState->objects().at(oldPlayer->state.heldObjectId)->type() == GameObject::KNIFE)
-        {
-            oldHeldObject = dynamic_cast<Knife*>(m_gameState->objects().at(oldPlayer->state.heldObjectId).get());
-            newHeldObject = std::make_shared<Knife>(m_gameState->nextID(), dynamic_cast<Knife*>(m_gameState->objects().at(oldPlayer->state.heldObjectId).get()));
-        }
-        else if(m_gameState->objects().at(oldPlayer->state.heldObjectId)->type() == GameObject::GUN)
-        {
-            oldHeldObject = dynamic_cast<Gun*>(m_gameState->objects().at(oldPlayer->state.heldObjectId).get());
-            newHeldObject = std::make_shared<Gun>(m_gameState->nextID(), dynamic_cast<Gun*>(m_gameState->objects().at(oldPlayer->state.heldObjectId).get()));
-        }
-        else
+        Throwable* oldHeldObject = objectCast<Throwable>(m_gameState->objects().at(oldPlayer->state().heldObjectId).get());
+        if(oldHeldObject == nullptr)
         {
             throw std::runtime_error("Unknown object type held by player");
         }
+        std::shared_ptr<Throwable> newHeldObject = std::static_pointer_cast<Throwable>(cloneObject(oldHeldObject, m_gameState->nextID()));
         newHeldObject->backwards = newPlayer->backwards;
-        newPlayer->state.heldObjectId = newHeldObject->id;
-        //newHeldObject->state.pos = newPlayer->state.pos;
-        newHeldObject->state.visible = newPlayer->state.visible;
-        newHeldObject->state.attachedObjectId = newPlayer->id;
+        newPlayer->state().heldObjectId = newHeldObject->id;
+        //newHeldObject->state().pos = newPlayer->state().pos;
+        newHeldObject->state().visible = newPlayer->state().visible;
+        newHeldObject->state().attachedObjectId = newPlayer->id;
 
         oldHeldObject->hasFinalTimeline = true;
         oldHeldObject->finalTimeline = m_gameState->currentTimeline() - 1;
@@ -416,19 +455,15 @@ void GameController::pushTimeline()
             newHeldObject->beginning = m_gameState->tick;
             newHeldObject->hasEnding = false;
         }
-        m_gameState->objects()[newHeldObject->id] = newHeldObject;
-        m_gameState->historyBuffer().buffer[newHeldObject->id] = std::vector<ObjectState>(m_gameState->tick+1);
-        m_gameState->historyBuffer().buffer[newHeldObject->id][m_gameState->tick] = newHeldObject->state;
-        m_gameState->throwables().push_back(newHeldObject.get());
+        m_gameState->spawnObject(newHeldObject);
     }
 
-    //Add a buffer to the new history buffer for the new player
-    m_gameState->historyBuffer().buffer[newPlayer->id] = std::vector<ObjectState>(m_gameState->tick+1);
-    m_gameState->historyBuffer().buffer[newPlayer->id][m_gameState->tick] = newPlayer->state;
+    //Only added now, so its history starts from where it ends up after getting in or out of a box
+    m_gameState->spawnObject(newPlayer);
 
     updateVisibilityGrids();
 
-    newPlayer->observations.resize(m_gameState->tick+1);
+    newPlayer->editObservations().resize(m_gameState->tick+1);
     observation::recordObservations(m_gameState.get(), newPlayer.get(), m_gameState->tick);
 
     //Delete all transient objects whose origin is "after" the breakpoint
@@ -471,9 +506,18 @@ void GameController::pushTimeline()
             {
                 obj->beginning = 0;
             }
+            //Crimes that end after the breakpoint are still going in the new timeline
+            Crime* crime = objectCast<Crime>(obj);
+            if(crime && crime->activeAt(m_gameState->tick))
+            {
+                m_gameState->crimeIndex().add(crime);
+            }
         }
     }
 
+    m_gameState->classifyObjects();
+    m_gameState->buildSignalGraph();
+    m_gameState->alarmMembership.invalidate();
 }
 
 void GameController::updateVisibilityGrids()
@@ -482,62 +526,55 @@ void GameController::updateVisibilityGrids()
 
     m_gameState->visibilityGrids.clear();
 
+    std::vector<Player*> activePlayers;
     for(Player* player : m_gameState->players())
     {
-        if(!player->activeAt(m_gameState->tick))
+        if(player->activeAt(m_gameState->tick))
         {
-            continue;
+            activePlayers.push_back(player);
         }
-
-        VisibilityGrid grid = search::playerVisibilityGrid(m_gameState.get(), player);
-        m_gameState->visibilityGrids[player->id] = std::move(grid);
     }
-}
 
-void GameController::updateAlarmConnections()
-{
-    //Clear temporary info from the last tick
-    for(Alarm * alarm : m_gameState->alarms())
+    //Each player's grid only depends on the obstruction grid, so they can all be worked out at once.
+    //Most players have been through this tick before (recorded players, rewinds, new timelines), so try the cache first
+    VisibilityCache & cache = m_gameState->visibilityCache;
+    int obstructionLayer = cache.obstructionLayer(m_gameState->obstructionGrid);
+    std::vector<VisibilityGrid> grids(activePlayers.size());
+    std::vector<char> computed(activePlayers.size(), false);
+    JobSystem::get().parallelFor(activePlayers.size(), 1, [&](int i)
     {
-        alarm->crimes.clear();
-        alarm->enemies.clear();
-    }
-    //Add crimes to their respective alarms' temporary info
-    for(Crime * crime : m_gameState->crimes())
+        VisibilityCache::Key key(activePlayers[i]->state(), obstructionLayer);
+        if(!cache.find(activePlayers[i]->id, m_gameState->tick, key, grids[i]))
+        {
+            grids[i] = search::playerVisibilityGrid(m_gameState.get(), activePlayers[i]);
+            computed[i] = true;
+        }
+    });
+    for(size_t i = 0; i < activePlayers.size(); i++)
     {
-        if(!crime->activeAt(m_gameState->tick) || crime->backwards != m_gameState->backwards()) 
+        if(computed[i])
         {
-            continue;
+            cache.store(activePlayers[i]->id, m_gameState->tick, VisibilityCache::Key(activePlayers[i]->state(), obstructionLayer), grids[i]);
         }
-        if(crime->assignedAlarm == -1)
+        else
         {
-            throw std::runtime_error("Crime has no assigned alarm!");
+            cache.touch(activePlayers[i]->id, m_gameState->tick);
         }
+        m_gameState->visibilityGrids[activePlayers[i]->id] = std::move(grids[i]);
+    }
+}
 
-        Alarm * alarm = dynamic_cast<Alarm*>(m_gameState->objects().at(crime->assignedAlarm).get());
-        alarm->crimes.push_back(crime->id);
+void GameController::updateAlarmConnections()
+{
+    m_gameState->updateAlarmMembership();
 
-        //By default assume the target will not be visible, tickEnemy can override this
-        crime->nextState.targetVisible = false;
-    }
-    //Add enemies to their respective alarms' temporary info
-    for(Enemy * enemy : m_gameState->enemies())
+    for(Alarm * alarm : m_gameState->alarms())
     {
-        if(!enemy->activeAt(m_gameState->tick) || enemy->backwards != m_gameState->backwards())
-        {
-            continue;
-        }
-        if(enemy->assignedAlarm == -1)
-        {
-            continue;
-        }
-        if(enemy->state.aiState == Enemy::AI_DEAD)
+        for(int crimeId : alarm->crimes)
         {
-            continue;
+            //By default assume the target will not be visible, tickEnemy can override this
+            m_gameState->getObject<Crime>(crimeId)->nextState().targetVisible = false;
         }
-
-        Alarm * alarm = dynamic_cast<Alarm*>(m_gameState->objects().at(enemy->assignedAlarm).get());
-        alarm->enemies.push_back(enemy->id);
     }
 
     //Alarms with no enemies left end all remaining crimes
@@ -554,7 +591,7 @@ void GameController::updateAlarmConnections()
 
         for(int crimeId : alarm->crimes)
         {
-            Crime * crime = dynamic_cast<Crime*>(m_gameState->objects().at(crimeId).get());
+            Crime * crime = objectCast<Crime>(m_gameState->objects().at(crimeId).get());
             if(crime->activeAt(m_gameState->tick))
             {
                 if(crime->backwards)
@@ -566,25 +603,11 @@ void GameController::updateAlarmConnections()
                     crime->hasEnding = true;
                     crime->ending = m_gameState->tick;
                 }
+                //It's still around for the rest of this tick
+                m_gameState->alarmMembership.crimeEnded(crime);
             }
         }
     }
-
-    //Handle crimes/alarms with the wrong backwardsness
-    for(Crime* crime : m_gameState->crimes())
-    {
-        if(crime->activeAt(m_gameState->tick) && crime->backwards != m_gameState->backwards())
-        {
-            crime->nextState = m_gameState->historyBuffer()[crime->id][m_gameState->tick];
-        }
-    }
-    for(Alarm* alarm : m_gameState->alarms())
-    {
-        if(alarm->activeAt(m_gameState->tick) && alarm->backwards != m_gameState->backwards())
-        {
-            alarm->nextState = m_gameState->historyBuffer()[alarm->id][m_gameState->tick];
-        }
-    }
 }
 
 void GameController::createPromises()
@@ -599,7 +622,7 @@ void GameController::createPromises()
             {
                 continue;
             }
-            float dist = math_util::dist(enemy->state.pos, m_gameState->mousePos);
+            float dist = math_util::dist(enemy->state().pos, m_gameState->mousePos);
             if(dist < closestDist)
             {
                 closestDist = dist;
@@ -610,7 +633,7 @@ void GameController::createPromises()
         {
             std::cout << "Promise of absence created for enemy " << closestEnemy->id << std::endl;
             std::shared_ptr<Promise> promise(new Promise(m_gameState->currentTimeline(), m_gameState->tick, closestEnemy->id, Promise::ABSENCE));
-            m_gameState->promises.push_back(promise);
+            m_gameState->promises.add(promise);
         }
         else
         {
@@ -618,88 +641,153 @@ void GameController::createPromises()
         }
     }
 
-    for(auto promise: m_gameState->promises)
+    for(Promise* promise : m_gameState->promises.activate(m_gameState->currentTimeline(), m_gameState->tick))
+    {
+        std::cout << "Promise of absence activated for enemy " << promise->target << " on tick " << m_gameState->tick << std::endl;
+    }
+}
+
+void GameController::wakeObjects()
+{
+    //Players interacting or throwing can switch, pick up or enter anything in reach
+    //This mirrors the checks in tickSwitch, tickThrowable and tickPlayer
+    for(Player* player : m_gameState->players())
+    {
+        if(player->backwards != m_gameState->backwards())
+        {
+            continue;
+        }
+        if(!player->state().willInteract && !player->state().willThrow)
+        {
+            continue;
+        }
+
+        for(auto & pair : m_gameState->objects())
+        {
+            GameObject* obj = pair.second.get();
+            if(obj->asleep && math_util::dist(player->state().pos, obj->state().pos) < (obj->size().x + Player::INTERACT_RADIUS))
+            {
+                obj->wake();
+            }
+        }
+    }
+
+    //Empty containers copy their occupancy from history wherever there is some
+    for(Container* container : m_gameState->containers())
     {
-        if(promise->activatedTimeline < 0 && m_gameState->tick < promise->originTick)
+        if(container->asleep && m_gameState->tick < m_gameState->historyBuffer()[container->id].size())
         {
-            promise->activatedTimeline = m_gameState->currentTimeline();
-            std::cout << "Promise of absence activated for enemy " << promise->target << " on tick " << m_gameState->tick << std::endl;
+            container->wake();
         }
     }
 }
 
+void GameController::evaluateAnalyticObjects()
+{
+    //A door responds to its switches one tick late
+    //Nothing can have flipped a switch before the first tick, so that uses the initial state
+    m_gameState->signalGraph().update(std::max(m_gameState->tick - 1, 0));
+
+    ComponentTable<Spikes> & spikes = m_gameState->table<Spikes>();
+    for(size_t i = 0; i < spikes.size(); i++)
+    {
+        tick::evaluateSpikes(m_gameState.get(), spikes.objects[i], spikes.states[i], spikes.components[i]);
+    }
+}
 
 void GameController::playTick()
 {
+    m_gameState->simLane().prepare(m_gameState->tick);
+    m_gameState->replayLane().prepare(m_gameState->tick);
+    wakeObjects();
+
     createPromises();
     updateAlarmConnections();
 
     tick::tickPlayer(m_gameState.get(), m_gameState->currentPlayer(), &m_controls);
-    for(Bullet* bullet : m_gameState->bullets())
+    //Bullets, throwables and spikes are ticked straight from their component tables
+    ComponentTable<Bullet> & bullets = m_gameState->table<Bullet>();
+    for(size_t i = 0; i < bullets.size(); i++)
     {
-        tick::tickBullet(m_gameState.get(), bullet);
+        if(bullets.objects[i]->replayed)
+        {
+            continue;
+        }
+        tick::tickBullet(m_gameState.get(), bullets.objects[i], bullets.states[i], bullets.components[i]);
     }
 
-    for(Enemy* enemy : m_gameState->enemies())
+    tick::resetThreatMap(m_gameState.get());
+
+    //Enemy AI is the heaviest part of the tick, so enemies are ticked in parallel.
+    //Anything an enemy does outside its own next state waits in its command buffer until they're all done
+    std::vector<Enemy*> & enemies = m_gameState->enemies();
+    std::vector<tick::EnemyCommandBuffer> enemyCommands(enemies.size());
+    JobSystem::get().parallelFor(enemies.size(), ENEMIES_PER_JOB, [&](int i)
+    {
+        if(!enemies[i]->replayed)
+        {
+            tick::tickEnemy(m_gameState.get(), enemies[i], enemyCommands[i]);
+        }
+    });
+    for(size_t i = 0; i < enemies.size(); i++)
     {
-        tick::tickEnemy(m_gameState.get(), enemy);
+        Enemy* enemy = enemies[i];
+        if(enemy->replayed)
+        {
+            continue;
+        }
+        tick::applyEnemyCommands(m_gameState.get(), enemy, enemyCommands[i]);
+        if(enemy->nextState().aiState == Enemy::AI_DEAD && enemy->state().aiState != Enemy::AI_DEAD && enemy->assignedAlarm != -1)
+        {
+            m_gameState->alarmMembership.enemyDied(enemy);
+        }
     }
 
     for(Container* container : m_gameState->containers())
     {
+        if(container->asleep)
+        {
+            continue;
+        }
         tick::tickContainer(m_gameState.get(), container);
     }
 
     for(Switch* sw : m_gameState->switches())
     {
+        if(sw->replayed || sw->asleep)
+        {
+            continue;
+        }
         tick::tickSwitch(m_gameState.get(), sw);
     }
 
-    for(Door* door : m_gameState->doors())
+    ComponentTable<Throwable> & throwables = m_gameState->table<Throwable>();
+    for(size_t i = 0; i < throwables.size(); i++)
     {
-        tick::tickDoor(m_gameState.get(), door);
+        Throwable* throwable = throwables.objects[i];
+        if(throwable->replayed || throwable->asleep)
+        {
+            continue;
+        }
+        tick::tickThrowable(m_gameState.get(), throwable, throwables.states[i], throwables.components[i]);
     }
 
-    for(Spikes* spikes : m_gameState->spikes())
-    {
-        tick::tickSpikes(m_gameState.get(), spikes);
-    }
+    //Everything has been ticked against the previous tick's states, so now analytic objects can move on to this tick
+    evaluateAnalyticObjects();
 
-    for(Throwable* throwable : m_gameState->throwables())
-    {
-        tick::tickThrowable(m_gameState.get(), throwable);
-    }
+    m_gameState->simLane().commit(m_gameState->tick);
 
-    //Apply next states to current states
-    for(auto pair : m_gameState->objects())
+    //Containers' occupancy spans follow their history
+    for(Container* container : m_gameState->containers())
     {
-        std::shared_ptr<GameObject> obj = pair.second;
-        if(!obj->activeAt(m_gameState->tick))
+        if(container->activeAt(m_gameState->tick))
         {
-            continue;
-        }
-
-        if(!obj->recorded)
-        {
-            obj->applyNextState();
-            if(m_gameState->tick == m_gameState->historyBuffer()[obj->id].size())
-            {  
-                m_gameState->historyBuffer()[obj->id].push_back(obj->state);
-            }
-            else if(m_gameState->tick > m_gameState->historyBuffer()[obj->id].size())
-            {
-                throw std::runtime_error("playTick: It is tick " + std::to_string(m_gameState->tick) + " but object " + std::to_string(obj->id) + " has history buffer size " + std::to_string(m_gameState->historyBuffer()[obj->id].size()));
-            }
-            else
-            {
-                m_gameState->historyBuffer()[obj->id][m_gameState->tick] = obj->state;
-            }
-        }
-        else
-        {
-            obj->state = m_gameState->historyBuffer()[obj->id][m_gameState->tick];
+            m_gameState->historyBuffer().occupancy.at(container->id).set(m_gameState->tick, container->state());
         }
     }
+    //Recorded and opposite-direction objects just get their state for this tick from history
+    m_gameState->replayLane().restore(m_gameState->tick);
+
     //Creating it both here and elsewhere because we want it to be right before recording observations
     updateVisibilityGrids();
     observation::recordObservations(m_gameState.get(), m_gameState->currentPlayer(), m_gameState->tick);
@@ -707,12 +795,6 @@ void GameController::playTick()
 
 void GameController::tick(TickType type)
 {
-    for(auto pair : m_gameState->objects())
-    {
-        std::shared_ptr<GameObject> obj = pair.second;
-        obj->nextState = obj->state;
-    }
-
     //Reset per-tick flags
     m_gameState->shouldReverse = false;
     m_gameState->boxToEnter = -1;
@@ -18,7 +18,6 @@
 #include <tick/tickEnemy.hh>
 #include <tick/tickContainer.hh>
 #include <tick/tickSwitch.hh>
-#include <tick/tickDoor.hh>
 #include <tick/tickSpikes.hh>
 #include <tick/tickThrowable.hh>
 
@@ -26,6 +25,7 @@
 #include <io/AudioPlayback.hh>
 #include <io/TextureBank.hh>
 #include <state/Level.hh>
+#include <state/WallVisibility.hh>
 #include <io/Controls.hh>
 #include <state/GameState.hh>
 #include <procedures/Search.hh>
@@ -33,6 +33,7 @@
 #include <io/Demo.hh>
 #include <io/LoadLevel.hh>
 #include <io/LoadJsonLevel.hh>
+#include <utils/JobSystem.hh>
 #include <vector>
 #include <iostream>
 #include <chrono>
@@ -54,6 +55,23 @@ private:
         PAUSE
     };
 
+    //Paradoxes a single player is caught in on the current tick
+    struct PlayerParadoxes
+    {
+        PlayerParadoxes()
+            : shot(false)
+            , spiked(false)
+        {
+        }
+
+        bool shot;
+        bool spiked;
+        //Description of a violated observation, empty if there wasn't one
+        std::string observation;
+    };
+
+    //Read-only, so it can be run for several players at once
+    PlayerParadoxes findPlayerParadoxes(Player* player);
     bool checkParadoxes();
     bool checkWin();
 
@@ -69,6 +87,10 @@ private:
 
     void createPromises();
 
+    void wakeObjects();
+
+    void evaluateAnalyticObjects();
+
     void playTick();
 
     void tick(TickType type);
@@ -82,6 +104,9 @@ private:
     std::shared_ptr<GameState> m_gameState;
 
     const bool timeMovesWhenYouMove = false;
+
+    //Enemies ticked per job. Pathfinding makes each enemy enough work to be worth a job of its own
+    constexpr static int ENEMIES_PER_JOB = 1;
 };
 
 #endif
\ No newline at end of file
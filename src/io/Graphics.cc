@@ -75,17 +75,20 @@ void Graphics::draw(GameState * state, point_t cameraCenter)
 
     m_window.clear();
 
+    //Work out visibility on another core while the crime search overlay is prepared here
     VisibilityGrid visibilityGrid;
-    if(state->players().size() > 0)
+    JobSystem::Group visibilityJob;
+    JobSystem::get().run(visibilityJob, [&]()
     {
-        visibilityGrid = search::playerVisibilityGrid(state, state->currentPlayer());
-    }
-    else
-    {
-        visibilityGrid = search::createVisibilityGrid(state, m_cameraWorldPos, 0, 360, 1000);
-    }
-
-     
+        if(state->players().size() > 0)
+        {
+            visibilityGrid = search::playerVisibilityGrid(state, state->currentPlayer());
+        }
+        else
+        {
+            visibilityGrid = search::createVisibilityGrid(state, m_cameraWorldPos, 0, 360, 1000);
+        }
+    });
 
     VisibilityGrid crimeSearchGrid(state->level->width, std::vector<bool>(state->level->height, false));
     for(Crime * crime : state->crimes())
@@ -102,7 +105,7 @@ void Graphics::draw(GameState * state, point_t cameraCenter)
                 {
                     continue;
                 }
-                point_t searchPos = crime->state.pos + (point_t(x * state->level->scale, y * state->level->scale));
+                point_t searchPos = crime->state().pos + (point_t(x * state->level->scale, y * state->level->scale));
                 point_t levelCoords = state->level->toLevelCoords(searchPos);
                 if(levelCoords.x < 0 || levelCoords.x >= state->level->width || levelCoords.y < 0 || levelCoords.y >= state->level->height)
                 {
@@ -113,14 +116,16 @@ void Graphics::draw(GameState * state, point_t cameraCenter)
         }
     }
 
+    JobSystem::get().wait(visibilityJob);
+
     //Draw each tile of the level
     for(int x = 0; x < state->level->width; ++x)
     {
         for(int y = 0; y < state->level->height; ++y)
         {
-            point_t worldPos = state->level->tiles[x][y].node.pos;
+            point_t worldPos = state->level->cellCenter(x, y);
             
-            if(state->level->tiles[x][y].type == Level::WALL)
+            if(state->level->tile(x, y).type == Level::WALL)
             {
                 if(crimeSearchGrid[x][y])
                 {
@@ -196,21 +201,21 @@ void Graphics::drawObj(GameObject* obj)
 {
     sf::Sprite & sprite = obj->getSprite();
 
-    setSpriteScale(sprite, obj->size);
+    setSpriteScale(sprite, obj->size());
 
-    point_t cameraPos = worldToCamera(obj->state.pos);
+    point_t cameraPos = worldToCamera(obj->state().pos);
     sprite.setPosition(sf::Vector2f(cameraPos));
-    sprite.setRotation(obj->state.angle_deg * -1.0f);
+    sprite.setRotation(obj->state().angle_deg * -1.0f);
     m_window.draw(sprite);
 }
 
 void Graphics::drawObjAs(GameObject* obj, sf::Sprite & sprite)
 {
-    setSpriteScale(sprite, obj->size);
+    setSpriteScale(sprite, obj->size());
 
-    point_t cameraPos = worldToCamera(obj->state.pos);
+    point_t cameraPos = worldToCamera(obj->state().pos);
     sprite.setPosition(sf::Vector2f(cameraPos));
-    sprite.setRotation(obj->state.angle_deg * -1.0f);
+    sprite.setRotation(obj->state().angle_deg * -1.0f);
     m_window.draw(sprite);
 }
 
@@ -249,11 +254,11 @@ void Graphics::drawObjects(GameState* state, const VisibilityGrid & visibilityGr
             continue;
         }
 
-        if(!obj->state.visible)
+        if(!obj->state().visible)
         {
             continue;
         }
-        point_t levelCoords = state->level->toLevelCoords(obj->state.pos);
+        point_t levelCoords = state->level->toLevelCoords(obj->state().pos);
         if(!state->level->levelCoordsInBounds(levelCoords) || !visibilityGrid[levelCoords.x][levelCoords.y])
         {
             continue;
@@ -274,12 +279,12 @@ void Graphics::drawObjects(GameState* state, const VisibilityGrid & visibilityGr
             continue;
         }
 
-        if(player->state.visible)
+        if(player->state().visible)
         {
             toDraw[player->id] = player;
         }
 
-        for(auto & obj : player->observations[state->tick])
+        for(auto & obj : player->observations()[state->tick])
         {
             //The object observed this timeline didn't match the originally observed object's ID
             //Mostly happens to bullets that get removed and recreated
@@ -340,13 +345,13 @@ void Graphics::drawDebug(GameState * state)
     //Draw patrol paths
     for(Enemy* enemy: state->enemies())
     {
-        if(enemy->patrolPoints.size() > 1)
+        if(enemy->patrolPoints().size() > 1)
         {
-            for(int i=0; i<enemy->patrolPoints.size(); i++)
+            for(int i=0; i<enemy->patrolPoints().size(); i++)
             {
-                size_t nextIndex = (i+1) % enemy->patrolPoints.size();
-                point_t start = worldToCamera(enemy->patrolPoints[i]);
-                point_t end = worldToCamera(enemy->patrolPoints[nextIndex]);
+                size_t nextIndex = (i+1) % enemy->patrolPoints().size();
+                point_t start = worldToCamera(enemy->patrolPoints()[i]);
+                point_t end = worldToCamera(enemy->patrolPoints()[nextIndex]);
                 sf::Vertex line[] =
                 {
                     sf::Vertex(sf::Vector2f(start.x, start.y)),
@@ -377,8 +382,8 @@ void Graphics::drawDebug(GameState * state)
                 continue;
             }
             Switch * swObj = static_cast<Switch*>(state->objects().at(sw).get());
-            point_t doorPos = worldToCamera(door->state.pos);
-            point_t swPos = worldToCamera(swObj->state.pos);
+            point_t doorPos = worldToCamera(door->state().pos);
+            point_t swPos = worldToCamera(swObj->state().pos);
             sf::Vertex line[] =
             {
                 sf::Vertex(sf::Vector2f(doorPos.x, doorPos.y)),
@@ -390,6 +395,34 @@ void Graphics::drawDebug(GameState * state)
         }
     }
 
+    //Shade every cell an enemy can see
+    const VisibilityGrid & threatened = state->threatMap.combined();
+    float halfCell = state->level->scale / 2.0f;
+    for(size_t x = 0; x < threatened.size(); x++)
+    {
+        for(size_t y = 0; y < threatened[x].size(); y++)
+        {
+            if(!threatened[x][y])
+            {
+                continue;
+            }
+            point_t center = state->level->cellCenter(x, y);
+            point_t corners[] =
+            {
+                worldToCamera(center + point_t(-halfCell, -halfCell)),
+                worldToCamera(center + point_t(halfCell, -halfCell)),
+                worldToCamera(center + point_t(halfCell, halfCell)),
+                worldToCamera(center + point_t(-halfCell, halfCell))
+            };
+            sf::Vertex quad[4];
+            for(int i=0; i<4; i++)
+            {
+                quad[i] = sf::Vertex(sf::Vector2f(corners[i].x, corners[i].y), sf::Color(255, 0, 0, 60));
+            }
+            m_window.draw(quad, 4, sf::Quads);
+        }
+    }
+
     //Draw alarm-enemy connections
     for(Alarm * alarm: state->alarms())
     {
@@ -399,8 +432,8 @@ void Graphics::drawDebug(GameState * state)
             {
                 continue;
             }
-            point_t alarmPos = worldToCamera(alarm->state.pos);
-            point_t enemyPos = worldToCamera(enemy->state.pos);
+            point_t alarmPos = worldToCamera(alarm->state().pos);
+            point_t enemyPos = worldToCamera(enemy->state().pos);
             sf::Vertex line[] =
             {
                 sf::Vertex(sf::Vector2f(alarmPos.x, alarmPos.y)),
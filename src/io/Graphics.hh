@@ -10,6 +10,7 @@
 #include <SFML/Graphics/Text.hpp>
 #include <state/GameState.hh>
 #include <procedures/Search.hh>
+#include <utils/JobSystem.hh>
 
 class Graphics
 {
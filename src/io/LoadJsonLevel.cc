@@ -60,17 +60,17 @@ void loadLevel(GameState * state, const std::string & levelName)
             case GameObject::PLAYER:
             {
                 std::shared_ptr<Player> player = std::make_shared<Player>(id);
-                player->state.pos = location;
+                player->state().pos = location;
                 state->addObject(player);
                 break;
             }
             case GameObject::ENEMY:
             {
                 std::shared_ptr<Enemy> enemy = std::make_shared<Enemy>(id);
-                enemy->state.pos = location;
+                enemy->state().pos = location;
                 for(json & point : object["patrolPoints"])
                 {
-                    enemy->patrolPoints.push_back(point_t(point["x"], point["y"]));
+                    enemy->definition->patrolPoints.push_back(point_t(point["x"], point["y"]));
                 }
                 if(object.find("assignedAlarm") != object.end())
                 {
@@ -86,18 +86,18 @@ void loadLevel(GameState * state, const std::string & levelName)
             case GameObject::SWITCH:
             {
                 std::shared_ptr<Switch> sw = std::make_shared<Switch>(id);
-                sw->state.pos = location;
-                sw->state.aiState = object["state"] == "on" ? Switch::ON : Switch::OFF;
+                sw->state().pos = location;
+                sw->state().aiState = object["state"] == "on" ? Switch::ON : Switch::OFF;
                 state->addObject(sw);
                 break;
             }
             case GameObject::DOOR:
             {
                 std::shared_ptr<Door> door = std::make_shared<Door>(id);
-                door->state.pos = location;
+                door->state().pos = location;
                 for(int sw : object["connectedSwitches"])
                 {
-                    door->connectedSwitches.push_back(sw);
+                    door->definition->connectedSwitches.push_back(sw);
                 }
                 state->addObject(door);
                 break;
@@ -105,28 +105,28 @@ void loadLevel(GameState * state, const std::string & levelName)
             case GameObject::TIMEBOX:
             {
                 std::shared_ptr<TimeBox> timeBox = std::make_shared<TimeBox>(id);
-                timeBox->state.pos = location;
+                timeBox->state().pos = location;
                 state->addObject(timeBox);
                 break;
             }
             case GameObject::CLOSET:
             {
                 std::shared_ptr<Closet> closet = std::make_shared<Closet>(id);
-                closet->state.pos = location;
+                closet->state().pos = location;
                 state->addObject(closet);
                 break;
             }
             case GameObject::TURNSTILE:
             {
                 std::shared_ptr<Turnstile> turnstile = std::make_shared<Turnstile>(id);
-                turnstile->state.pos = location;
+                turnstile->state().pos = location;
                 state->addObject(turnstile);
                 break;
             }
             case GameObject::SPIKES:
             {
                 std::shared_ptr<Spikes> spikes = std::make_shared<Spikes>(id);
-                spikes->state.pos = location;
+                spikes->state().pos = location;
                 spikes->downDuration = object["downDuration"];
                 spikes->upDuration = object["upDuration"];
                 spikes->cycleOffset = object["cycleOffset"];
@@ -136,35 +136,35 @@ void loadLevel(GameState * state, const std::string & levelName)
             case GameObject::OBJECTIVE:
             {
                 std::shared_ptr<Objective> objective = std::make_shared<Objective>(id);
-                objective->state.pos = location;
+                objective->state().pos = location;
                 state->addObject(objective);
                 break;
             }
             case GameObject::KNIFE:
             {
                 std::shared_ptr<Knife> knife = std::make_shared<Knife>(id);
-                knife->state.pos = location;
+                knife->state().pos = location;
                 state->addObject(knife);
                 break;
             }
             case GameObject::GUN:
             {
                 std::shared_ptr<Gun> gun = std::make_shared<Gun>(id);
-                gun->state.pos = location;
+                gun->state().pos = location;
                 state->addObject(gun);
                 break;
             }
             case GameObject::EXIT:
             {
                 std::shared_ptr<Exit> exit = std::make_shared<Exit>(id);
-                exit->state.pos = location;
+                exit->state().pos = location;
                 state->addObject(exit);
                 break;
             }
             case GameObject::ALARM:
             {
                 std::shared_ptr<Alarm> alarm = std::make_shared<Alarm>(id);
-                alarm->state.pos = location;
+                alarm->state().pos = location;
                 state->addObject(alarm);
                 break;
             }
@@ -195,11 +195,11 @@ void saveLevel(GameState * state, const std::string & levelName)
     {
         for(int x = 0; x < state->level->width; x++)
         {
-            if(state->level->tiles[x][y].type == Level::EMPTY)
+            if(state->level->tile(x, y).type == Level::EMPTY)
             {
                 levelData << ".";
             }
-            else if(state->level->tiles[x][y].type == Level::WALL)
+            else if(state->level->tile(x, y).type == Level::WALL)
             {
                 levelData << "X";
             }
@@ -221,8 +221,8 @@ void saveLevel(GameState * state, const std::string & levelName)
         objData["id"] = obj->id;
         
         json pos;
-        pos["x"] = obj->state.pos.x;
-        pos["y"] = obj->state.pos.y;
+        pos["x"] = obj->state().pos.x;
+        pos["y"] = obj->state().pos.y;
 
         objData["pos"] = pos;
 
@@ -238,7 +238,7 @@ void saveLevel(GameState * state, const std::string & levelName)
 
                 json patrolPoints = json::array();
 
-                for(point_t patrolPoint : enemy->patrolPoints)
+                for(point_t patrolPoint : enemy->patrolPoints())
                 {
                     json point;
                     point["x"] = patrolPoint.x;
@@ -252,7 +252,7 @@ void saveLevel(GameState * state, const std::string & levelName)
             case GameObject::SWITCH:
             {
                 Switch * sw = static_cast<Switch*>(obj);
-                objData["state"] = sw->state.aiState == Switch::ON ? "on" : "off";
+                objData["state"] = sw->state().aiState == Switch::ON ? "on" : "off";
                 break;
             }
             case GameObject::DOOR:
@@ -327,4 +327,10 @@ bool levelExists(const std::string & levelName)
     return file.is_open();
 }
 
+std::string levelFilePath(const std::string & levelName, const std::string & extension)
+{
+    std::string BASE_LEVEL_DIR = "./levels/";
+    return BASE_LEVEL_DIR + levelName + extension;
+}
+
 }//namespace jsonlevel
\ No newline at end of file
@@ -12,6 +12,9 @@ void saveLevel(GameState * state, const std::string & levelName);
 
 bool levelExists(const std::string & levelName);
 
+//Where to keep other files that belong to a level, like its wall visibility table
+std::string levelFilePath(const std::string & levelName, const std::string & extension);
+
 }
 
 
@@ -69,7 +69,7 @@ void constructObject(GameState * state, int id, const std::string & objType, poi
         for(int i=3; i<tokens.size(); i++)
         {
             std::string patrolPoint = tokens[i];
-            enemy->patrolPoints.push_back(parsePoint(patrolPoint));
+            enemy->definition->patrolPoints.push_back(parsePoint(patrolPoint));
         }
         obj = enemy;
     }
@@ -84,11 +84,11 @@ void constructObject(GameState * state, int id, const std::string & objType, poi
         std::string startingState = tokens[3];
         if(startingState == "on")
         {
-            sw->state.aiState = Switch::ON;
+            sw->state().aiState = Switch::ON;
         }
         else if(startingState == "off")
         {
-            sw->state.aiState = Switch::OFF;
+            sw->state().aiState = Switch::OFF;
         }
         else
         {
@@ -104,7 +104,7 @@ void constructObject(GameState * state, int id, const std::string & objType, poi
             int switchID = std::stoi(tokens[i]);
             
             std::cout << "Switch ID: " << switchID << std::endl;
-            door->connectedSwitches.push_back(switchID);
+            door->definition->connectedSwitches.push_back(switchID);
         }
         obj = door;
     }
@@ -160,7 +160,7 @@ void constructObject(GameState * state, int id, const std::string & objType, poi
         throw std::runtime_error("Unknown object type " + objType);
     }
 
-    obj->state.pos = position;
+    obj->state().pos = position;
     state->addObject(obj);
 }
 
@@ -254,11 +254,11 @@ void saveLevel(GameState * state, const std::string & levelName)
     {
         for(int x = 0; x < state->level->width; x++)
         {
-            if(state->level->tiles[x][y].type == Level::EMPTY)
+            if(state->level->tile(x, y).type == Level::EMPTY)
             {
                 file << ".";
             }
-            else if(state->level->tiles[x][y].type == Level::WALL)
+            else if(state->level->tile(x, y).type == Level::WALL)
             {
                 file << "X";
             }
@@ -273,7 +273,7 @@ void saveLevel(GameState * state, const std::string & levelName)
     for(auto pair : state->objects())
     {
         GameObject * obj = pair.second.get();
-        file << GameObject::typeToString(obj->type()) << " " << obj->id << " " << obj->state.pos.x << "," << obj->state.pos.y;
+        file << GameObject::typeToString(obj->type()) << " " << obj->id << " " << obj->state().pos.x << "," << obj->state().pos.y;
 
         switch(obj->type())
         {
@@ -284,7 +284,7 @@ void saveLevel(GameState * state, const std::string & levelName)
             case GameObject::ENEMY:
             {
                 Enemy * enemy = static_cast<Enemy*>(obj);
-                for(point_t patrolPoint : enemy->patrolPoints)
+                for(point_t patrolPoint : enemy->patrolPoints())
                 {
                     file << " " << patrolPoint.x << "," << patrolPoint.y;
                 }
@@ -293,7 +293,7 @@ void saveLevel(GameState * state, const std::string & levelName)
             case GameObject::SWITCH:
             {
                 Switch * sw = static_cast<Switch*>(obj);
-                file << " " << (sw->state.aiState == Switch::ON ? "on" : "off");
+                file << " " << (sw->state().aiState == Switch::ON ? "on" : "off");
                 break;
             }
             case GameObject::DOOR:
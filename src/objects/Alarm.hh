@@ -11,8 +11,7 @@ public:
     Alarm(int id)
         : GameObject(id)
     {
-        colliderType = CIRCLE;
-        size = point_t(20, 20);
+        setCollider(CIRCLE, point_t(20, 20));
         setupSprites({"alarm.png"});
     }
 
@@ -21,9 +20,17 @@ public:
     {
     }
 
+    constexpr static ObjectType TYPE = ALARM;
+    constexpr static const char * TYPE_NAME = "alarm";
+
     ObjectType type() override
     {
-        return ALARM;
+        return TYPE;
+    }
+
+    bool canSleep() override
+    {
+        return true;
     }
 
     bool isTransient() override
@@ -36,7 +43,8 @@ public:
         return true;
     }
 
-    //These should be updated every tick based on the state of enemies/crimes
+    //Live enemies and active crimes under this alarm in the current timeline
+    //Kept up to date by GameState::updateAlarmMembership at the start of each tick
     std::vector<int> enemies;
     std::vector<int> crimes;
 
@@ -6,7 +6,6 @@ Bullet::Bullet(int id)
     , velocity(0, 0)
 {
 
-    colliderType = CIRCLE;
-    size = point_t(5, 5);
+    setCollider(CIRCLE, point_t(5, 5));
     setupSprites({"blam.png"});
 }
\ No newline at end of file
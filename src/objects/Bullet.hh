@@ -4,6 +4,12 @@
 #include "GameObject.hh"
 #include <utils/MathUtil.hh>
 
+//What tickBullet needs besides the bullet's state, kept in the timeline's bullet table
+struct BulletMotion
+{
+    point_t velocity;
+};
+
 class Bullet : public GameObject
 {
 public:
@@ -24,9 +30,12 @@ public:
         return true;
     }
 
+    constexpr static ObjectType TYPE = BULLET;
+    constexpr static const char * TYPE_NAME = "bullet";
+
     ObjectType type() override
     {
-        return BULLET;
+        return TYPE;
     }
 
     point_t velocity;
@@ -12,8 +12,7 @@ public:
     Closet(int id)
         : Container(id, false, false)
     {
-        colliderType = BOX;
-        size = point_t(25, 25);
+        setCollider(BOX, point_t(25, 25));
         setupSprites({"closet.png"});
     }
 
@@ -22,9 +21,12 @@ public:
     {
     }
 
+    constexpr static ObjectType TYPE = CLOSET;
+    constexpr static const char * TYPE_NAME = "closet";
+
     ObjectType type() override
     {
-        return CLOSET;
+        return TYPE;
     }
 };
 
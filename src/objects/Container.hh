@@ -26,6 +26,12 @@ public:
     {
     }
 
+    //Only an empty box is idle. GameController::wakeObjects also wakes boxes replaying recorded occupancy
+    bool canSleep() override
+    {
+        return activeOccupant == -1;
+    }
+
     int activeOccupant;
     const bool reverseOnEnter;
     const bool reverseOnExit;
@@ -2,23 +2,22 @@
 #define __CRIME_HH__
 
 #include <objects/GameObject.hh>
+#include <utils/SearchMask.hh>
+
+#include <memory>
 
 class Crime : public GameObject
 {
 public:
-    //Overall 7x7 grid, largest that can fit in 64-bit int
+    //Overall 7x7 grid
     constexpr static int SEARCH_RADIUS = 3;
     constexpr static int SEARCH_DIAMETER = 2 * SEARCH_RADIUS + 1;
 
-    constexpr static uint64_t FULLY_SEARCHED()
-    {
-        uint64_t FULLY_SEARCHED = 0;
-        for(int i=0; i<SEARCH_DIAMETER * SEARCH_DIAMETER; i++)
-        {
-            FULLY_SEARCHED |= 1 << i;
-        }
-        return FULLY_SEARCHED;
-    }
+    typedef SearchMask<SEARCH_RADIUS> Mask;
+    typedef SearchMaskTable<SEARCH_RADIUS> MaskTable;
+
+    //ObjectState::searchMask value for a crime where nothing has been searched yet
+    constexpr static int NOTHING_SEARCHED = 0;
 
     enum CrimeType
     {
@@ -30,9 +29,9 @@ public:
         : GameObject(id)
         , subjectId(-1)
         , assignedAlarm(-1)
+        , m_searchMasks(std::make_shared<MaskTable>())
     {
-        colliderType = CIRCLE;
-        size = point_t(10, 10);
+        setCollider(CIRCLE, point_t(10, 10));
         setupSprites({"crime.png"});
     }
 
@@ -41,12 +40,16 @@ public:
         , crimeType(ancestor->crimeType)
         , subjectId(ancestor->subjectId)
         , assignedAlarm(ancestor->assignedAlarm)
+        , m_searchMasks(ancestor->m_searchMasks)
     {
     }
 
+    constexpr static ObjectType TYPE = CRIME;
+    constexpr static const char * TYPE_NAME = "crime";
+
     ObjectType type() override
     {
-        return CRIME;
+        return TYPE;
     }
     
     bool isTransient() override
@@ -61,29 +64,41 @@ public:
 
     void submitSearch(int x, int y)
     {
-        if(x > SEARCH_RADIUS || x < -SEARCH_RADIUS || y > SEARCH_RADIUS || y < -SEARCH_RADIUS)
+        Mask mask = (*m_searchMasks)[nextState().searchMask];
+        if(mask.test(x, y))
         {
-            throw std::runtime_error("Crime::submitSearch: input is out of bounds");
+            return;
         }
-        int idx = x * SEARCH_DIAMETER + y;
-
-        nextState.searchStatus |= 1 << idx;
+        mask.set(x, y);
+        //Searching the same cells again after a rewind reuses the mask from last time
+        nextState().searchMask = m_searchMasks->intern(mask);
     }
+
     bool isSearched(int x, int y)
     {
-        if(x > SEARCH_RADIUS || x < -SEARCH_RADIUS || y > SEARCH_RADIUS || y < -SEARCH_RADIUS)
-        {
-            throw std::runtime_error("Crime::isSearched: input is out of bounds");
-        }
-        int idx = x * SEARCH_DIAMETER + y;
+        return (*m_searchMasks)[state().searchMask].test(x, y);
+    }
+
+    //Will every cell have been searched once this tick is applied?
+    bool willBeFullySearched()
+    {
+        return (*m_searchMasks)[nextState().searchMask].full();
+    }
 
-        return state.searchStatus & (1 << idx);
+    void clearSearch()
+    {
+        nextState().searchMask = NOTHING_SEARCHED;
     }
 
     CrimeType crimeType;
     int subjectId;
     int assignedAlarm;
 
+private:
+    //Masks grow with the search radius, so rather than keeping one in every object's state, ObjectState only holds an index into this table.
+    //Each crime has its own table, shared with its copies in other timelines and freed along with the last of them
+    std::shared_ptr<MaskTable> m_searchMasks;
+
 };
 
 #endif
\ No newline at end of file
@@ -4,17 +4,16 @@
 Door::Door(int id)
     : GameObject(id)
 {
-    colliderType = BOX;
-    size = point_t(20, 20);
+    setCollider(BOX, point_t(20, 20));
     setupSprites({"Closed.png", "Open.png"});
 }
 
 void Door::addSwitch(Switch* sw)
 {
-    connectedSwitches.push_back(sw->id);
+    definition->connectedSwitches.push_back(sw->id);
 }
 
 const std::vector<int>& Door::getConnectedSwitches() const
 {
-    return connectedSwitches;
+    return definition->connectedSwitches;
 }
@@ -17,7 +17,6 @@ public:
 
     Door(int id, Door* ancestor)
         : GameObject(id, ancestor)
-        , connectedSwitches(ancestor->connectedSwitches)
     {
     }
 
@@ -27,15 +26,21 @@ public:
 
     bool isObstruction() override
     {
-        return state.aiState == CLOSED;
+        return state().aiState == CLOSED;
     }
 
+    constexpr static ObjectType TYPE = DOOR;
+    constexpr static const char * TYPE_NAME = "door";
+
     ObjectType type() override
     {
-        return DOOR;
+        return TYPE;
     }
 
-    std::vector<int> connectedSwitches;
+    bool isAnalytic() override
+    {
+        return true;
+    }
 };
 
 #endif
@@ -5,7 +5,6 @@ Enemy::Enemy(int id)
     : GameObject(id)
     , assignedAlarm(-1)
 {
-    colliderType = CIRCLE;
-    size = point_t(10, 10);
+    setCollider(CIRCLE, point_t(10, 10));
     setupSprites({"bored.png", "frowny.png", "enraged.png", "dead.png", "searching.png"});
 }
\ No newline at end of file
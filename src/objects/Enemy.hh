@@ -30,17 +30,22 @@ public:
 
     Enemy(int id, Enemy* ancestor)
         : GameObject(id, ancestor)
-        , patrolPoints(ancestor->patrolPoints)
         , assignedAlarm(ancestor->assignedAlarm)
     {
     }
 
+    constexpr static ObjectType TYPE = ENEMY;
+    constexpr static const char * TYPE_NAME = "enemy";
+
     ObjectType type() override
     {
-        return ENEMY;
+        return TYPE;
     }
 
-    std::vector<point_t> patrolPoints;
+    const std::vector<point_t> & patrolPoints() const
+    {
+        return definition->patrolPoints;
+    }
 
     int assignedAlarm;
 };
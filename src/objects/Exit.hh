@@ -9,8 +9,7 @@ public:
     Exit(int id)
         : GameObject(id)
     {
-        colliderType = BOX;
-        size = point_t(20, 20);
+        setCollider(BOX, point_t(20, 20));
         setupSprites({"exit.png"});
     }
 
@@ -19,9 +18,17 @@ public:
     {
     }
 
+    constexpr static ObjectType TYPE = EXIT;
+    constexpr static const char * TYPE_NAME = "exit";
+
     ObjectType type() override
     {
-        return EXIT;
+        return TYPE;
+    }
+
+    bool canSleep() override
+    {
+        return true;
     }
 };
 
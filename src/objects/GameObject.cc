@@ -1,10 +1,34 @@
 #include "GameObject.hh"
+#include "ObjectTypes.hh"
 #include <iostream>
 #include <utils/CollisionUtil.hh>
 
+std::string GameObject::typeToString(ObjectType type)
+{
+    std::string name = "undefined";
+    ObjectTypes::visit(type, [&]<typename T>(std::type_identity<T>)
+    {
+        name = T::TYPE_NAME;
+    });
+    return name;
+}
+
+GameObject::ObjectType GameObject::stringToType(const std::string & str)
+{
+    ObjectType type = UNDEFINED;
+    ObjectTypes::forEach([&]<typename T>(std::type_identity<T>)
+    {
+        if(str == T::TYPE_NAME)
+        {
+            type = T::TYPE;
+        }
+    });
+    return type;
+}
+
 GameObject::GameObject(int id)
     : id(id)
-    , colliderType(NONE)
+    , definition(std::make_shared<ObjectDefinition>())
     , backwards(false)
     , beginning(0)
     , hasEnding(false)
@@ -13,16 +37,16 @@ GameObject::GameObject(int id)
     , hasFinalTimeline(false)
     , finalTimeline(0)
     , recorded(false)
+    , replayed(false)
+    , asleep(false)
+    , m_states(&m_ownStates)
 {
 
 }
 
 GameObject::GameObject(int id, GameObject* ancestor)
     : id(id)
-    , colliderType(ancestor->colliderType)
-    , size(ancestor->size)
-    , state(ancestor->state)
-    , sprites(ancestor->sprites)
+    , definition(ancestor->definition)
     , backwards(ancestor->backwards)
     , beginning(ancestor->beginning)
     , hasEnding(ancestor->hasEnding)
@@ -31,41 +55,44 @@ GameObject::GameObject(int id, GameObject* ancestor)
     , hasFinalTimeline(ancestor->hasFinalTimeline)
     , finalTimeline(ancestor->finalTimeline)
     , recorded(ancestor->recorded)
+    , replayed(ancestor->replayed)
+    , asleep(false)
+    , m_states(&m_ownStates)
 {
-
+    m_ownStates.current() = ancestor->state();
 }
 
 float GameObject::radius() const
 {
-    return size.x / 2.0f;
+    return size().x / 2.0f;
 }
 
 bool GameObject::isColliding(GameObject& other)
 {
-    if(colliderType==CIRCLE)
+    if(colliderType()==CIRCLE)
     {
-        if(other.colliderType==CIRCLE)
+        if(other.colliderType()==CIRCLE)
         {
-            return math_util::dist(state.pos, other.state.pos) < (radius() + other.radius());
+            return math_util::dist(state().pos, other.state().pos) < (radius() + other.radius());
         }
-        else if(other.colliderType==BOX)
+        else if(other.colliderType()==BOX)
         {
-            return collision::boxCircle(other.state.pos, other.size, state.pos, radius());
+            return collision::boxCircle(other.state().pos, other.size(), state().pos, radius());
         }
     }
-    else if(colliderType==BOX)
+    else if(colliderType()==BOX)
     {
-        if(other.colliderType==CIRCLE)
+        if(other.colliderType()==CIRCLE)
         {
-            return collision::boxCircle(state.pos, size, other.state.pos, other.radius());
+            return collision::boxCircle(state().pos, size(), other.state().pos, other.radius());
         }
-        else if(other.colliderType==BOX)
+        else if(other.colliderType()==BOX)
         {
             //Top right, bottom left
-            point_t tr1 = state.pos + (size / 2.0f);
-            point_t bl1 = state.pos - (size / 2.0f);
-            point_t tr2 = other.state.pos + (other.size / 2.0f);
-            point_t bl2 = other.state.pos - (other.size / 2.0f);
+            point_t tr1 = state().pos + (size() / 2.0f);
+            point_t bl1 = state().pos - (size() / 2.0f);
+            point_t tr2 = other.state().pos + (other.size() / 2.0f);
+            point_t bl2 = other.state().pos - (other.size() / 2.0f);
 
             return (tr1.y > bl2.y && bl2.y < tr2.y && bl1.x < tr2.x && tr1.x > bl2.x);
         }
@@ -77,14 +104,14 @@ bool GameObject::isColliding(GameObject& other)
 
 bool GameObject::isColliding(point_t point)
 {
-    if(colliderType==CIRCLE)
+    if(colliderType()==CIRCLE)
     {
-        return math_util::dist(state.pos, point) < radius();
+        return math_util::dist(state().pos, point) < radius();
     }
-    else if(colliderType==BOX)
+    else if(colliderType()==BOX)
     {
-        point_t tr = state.pos + (size / 2.0f);
-        point_t bl = state.pos - (size / 2.0f);
+        point_t tr = state().pos + (size() / 2.0f);
+        point_t bl = state().pos - (size() / 2.0f);
 
         return (point.y > bl.y && point.y < tr.y && point.x > bl.x && point.x < tr.x);
     }
@@ -1,19 +1,14 @@
 #ifndef __GAME_OBJECT_HH__
 #define __GAME_OBJECT_HH__
 
+#include "ObjectDefinition.hh"
 #include <utils/MathUtil.hh>
 #include <io/TextureBank.hh>
 #include <SFML/Graphics/Sprite.hpp>
 #include <initializer_list>
+#include <memory>
 #include <vector>
 
-enum ColliderType{
-    NONE,
-    CIRCLE,
-    //Axis-aligned box
-    BOX
-};
-
 struct ObjectState
 {
     ObjectState()
@@ -31,10 +26,11 @@ struct ObjectState
         , chargeTime(0)
         , willInteract(false)
         , willThrow(false)
+        , willFire(false)
         , holdingObject(false)
         , heldObjectId(-1)
         , speed(0)
-        , searchStatus(0)
+        , searchMask(0)
         , discovered(false)
         , targetVisible(false)
     {
@@ -56,15 +52,18 @@ struct ObjectState
         , chargeTime(other.chargeTime)
         , willInteract(other.willInteract)
         , willThrow(other.willThrow)
+        , willFire(other.willFire)
         , holdingObject(other.holdingObject)
         , heldObjectId(other.heldObjectId)
         , speed(other.speed)
-        , searchStatus(other.searchStatus)
+        , searchMask(other.searchMask)
         , discovered(other.discovered)
         , targetVisible(other.targetVisible)
     {
     }
 
+    bool operator==(const ObjectState& other) const = default;
+
     point_t pos;
     //Angle the entity is facing towards
     //0 is right, 90 is up, 180 is left, 270 is down
@@ -101,11 +100,34 @@ struct ObjectState
 
 
     //Crime/alarm related params
-    uint64_t searchStatus;
+    int searchMask; //Index into the crime's search mask table
     bool discovered; //For dead enemies
     bool targetVisible;
 };
 
+//An object's committed state and the one being built up for the tick in progress. The two swap roles every tick.
+//Objects in a timeline keep theirs in the timeline's component tables (see ObjectTypes.hh)
+struct StateBuffer
+{
+    StateBuffer()
+        : currentIdx(0)
+    {
+    }
+
+    ObjectState& current()
+    {
+        return states[currentIdx];
+    }
+
+    ObjectState& next()
+    {
+        return states[1 - currentIdx];
+    }
+
+    ObjectState states[2];
+    int currentIdx;
+};
+
 class GameObject
 {
 public:
@@ -126,118 +148,19 @@ public:
         GUN,
         EXIT,
         CRIME,
-        ALARM
+        ALARM,
+        N_OBJECT_TYPES
     };
 
-    static std::string typeToString(ObjectType type)
-    {
-        switch(type)
-        {
-            case PLAYER:
-                return "player";
-            case BULLET:
-                return "bullet";
-            case ENEMY:
-                return "enemy";
-            case TIMEBOX:
-                return "timebox";
-            case SWITCH:
-                return "switch";
-            case DOOR:
-                return "door";
-            case CLOSET:
-                return "closet";
-            case TURNSTILE:
-                return "turnstile";
-            case SPIKES:
-                return "spikes";
-            case OBJECTIVE:
-                return "objective";
-            case KNIFE:
-                return "knife";
-            case GUN:
-                return "gun";
-            case EXIT:
-                return "exit";
-            case CRIME:
-                return "crime";
-            case ALARM:
-                return "alarm";
-            default:
-                return "undefined";
-        }
-    }
-
-    static ObjectType stringToType(const std::string & str)
-    {
-        if(str == "player")
-        {
-            return PLAYER;
-        }
-        else if(str == "bullet")
-        {
-            return BULLET;
-        }
-        else if(str == "enemy")
-        {
-            return ENEMY;
-        }
-        else if(str == "timebox")
-        {
-            return TIMEBOX;
-        }
-        else if(str == "switch")
-        {
-            return SWITCH;
-        }
-        else if(str == "door")
-        {
-            return DOOR;
-        }
-        else if(str == "closet")
-        {
-            return CLOSET;
-        }
-        else if(str == "turnstile")
-        {
-            return TURNSTILE;
-        }
-        else if(str == "spikes")
-        {
-            return SPIKES;
-        }
-        else if(str == "objective")
-        {
-            return OBJECTIVE;
-        }
-        else if(str == "knife")
-        {
-            return KNIFE;
-        }
-        else if(str == "gun")
-        {
-            return GUN;
-        }
-        else if(str == "exit")
-        {
-            return EXIT;
-        }
-        else if(str == "crime")
-        {
-            return CRIME;
-        }
-        else if(str == "alarm")
-        {
-            return ALARM;
-        }
-        else
-        {
-            return UNDEFINED;
-        }
-    }
+    //Both go through the list in ObjectTypes.hh
+    static std::string typeToString(ObjectType type);
+    static ObjectType stringToType(const std::string & str);
 
     GameObject(int id);
     GameObject(int id, GameObject* ancestor);
+    //An object in a timeline keeps its states in the timeline's tables, so objects are cloned (see cloneObject) rather than copied
+    GameObject(const GameObject&) = delete;
+    GameObject& operator=(const GameObject&) = delete;
 
     //A virtual function is necessary for polymorphism
     virtual ~GameObject() {}
@@ -251,9 +174,26 @@ public:
         return tick >= beginning && (!hasEnding || tick <= ending);
     }
 
+    ColliderType colliderType() const
+    {
+        return definition->colliderType;
+    }
+
+    const point_t & size() const
+    {
+        return definition->size;
+    }
+
     sf::Sprite& getSprite()
     {
-        return sprites[state.animIdx];
+        return definition->sprites[state().animIdx];
+    }
+
+    //Only for constructors, while the definition is still this object's own
+    void setCollider(ColliderType type, point_t size)
+    {
+        definition->colliderType = type;
+        definition->size = size;
     }
 
     void setupSprites(std::initializer_list<const char*> filenames)
@@ -262,13 +202,75 @@ public:
         {
             sf::Sprite sprite;
             sprite.setTexture(TextureBank::get(filename));
-            sprites.push_back(sprite);
+            definition->sprites.push_back(sprite);
         }
     }
 
+    //State as of the last committed tick
+    ObjectState& state()
+    {
+        return m_states->current();
+    }
+
+    //State being built up for the tick in progress
+    ObjectState& nextState()
+    {
+        return m_states->next();
+    }
+
+    //Start the next state from the committed one before ticking
+    void prepareNextState()
+    {
+        m_states->next() = m_states->current();
+    }
+
+    //The two state buffers swap roles, so committing a tick doesn't copy anything
     void applyNextState()
     {
-        state = nextState;
+        m_states->currentIdx = 1 - m_states->currentIdx;
+    }
+
+    const StateBuffer& stateBuffer() const
+    {
+        return *m_states;
+    }
+
+    //Called by ComponentTable when this object joins or leaves a timeline's table.
+    //Until it joins one, and after it leaves, its states are kept in the object itself
+    void attachStates(StateBuffer* states)
+    {
+        m_states = states;
+    }
+
+    void detachStates()
+    {
+        m_ownStates = *m_states;
+        m_states = &m_ownStates;
+    }
+
+    //Bring a sleeping object back into the tick. Its next state went stale while it slept
+    void wake()
+    {
+        if(asleep)
+        {
+            asleep = false;
+            prepareNextState();
+        }
+    }
+
+    //Is this object's state a pure function of the tick and other objects' history?
+    //Analytic objects are evaluated for whatever tick is current (see GameController::evaluateAnalyticObjects)
+    //rather than ticked, and they have no history of their own
+    virtual bool isAnalytic()
+    {
+        return false;
+    }
+
+    //Can this object stop ticking while its state isn't changing?
+    //Only true for objects whose tick can't change anything unless one of GameController::wakeObjects' triggers fires
+    virtual bool canSleep()
+    {
+        return false;
     }
 
     virtual bool isObstruction()
@@ -292,14 +294,10 @@ public:
 
     int drawPriority();
 
-    ColliderType colliderType;
-
     int id;
-    ObjectState state;
-    point_t size;
-    ObjectState nextState;
 
-    std::vector<sf::Sprite> sprites;
+    //Shared with every copy of this object
+    std::shared_ptr<ObjectDefinition> definition;
 
     bool backwards;
 
@@ -318,6 +316,20 @@ public:
     int finalTimeline;
 
     bool recorded;
+
+    //Is this object's state replayed from history in the current timeline instead of being simulated?
+    //Set by GameState::classifyObjects
+    bool replayed;
+
+    //Did this object come out of its last tick unchanged? Sleeping objects skip their tick
+    //and hold their state in history until something wakes them
+    bool asleep;
+
+private:
+    //Used while the object isn't in a timeline
+    StateBuffer m_ownStates;
+    //Where the object's states actually are
+    StateBuffer* m_states;
 };
 
 #endif
@@ -9,8 +9,7 @@ public:
     Gun(int id)
         : Throwable(id)
     {
-        colliderType = CIRCLE;
-        size = point_t(10, 10);
+        setCollider(CIRCLE, point_t(10, 10));
         setupSprites({"gun.png"});
 
         deadly = false;
@@ -27,9 +26,12 @@ public:
     {
     }
 
+    constexpr static ObjectType TYPE = GUN;
+    constexpr static const char * TYPE_NAME = "gun";
+
     ObjectType type() override
     {
-        return GUN;
+        return TYPE;
     }
 };
 
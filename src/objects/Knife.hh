@@ -9,8 +9,7 @@ public:
     Knife(int id)
         : Throwable(id)
     {
-        colliderType = CIRCLE;
-        size = point_t(10, 10);
+        setCollider(CIRCLE, point_t(10, 10));
         setupSprites({"knife.png"});
 
         deadly = true;
@@ -27,9 +26,12 @@ public:
     {
     }
 
+    constexpr static ObjectType TYPE = KNIFE;
+    constexpr static const char * TYPE_NAME = "knife";
+
     ObjectType type() override
     {
-        return KNIFE;
+        return TYPE;
     }
 };
 
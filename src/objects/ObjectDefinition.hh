@@ -0,0 +1,40 @@
+#ifndef __OBJECT_DEFINITION_HH__
+#define __OBJECT_DEFINITION_HH__
+
+#include <utils/MathUtil.hh>
+#include <SFML/Graphics/Sprite.hpp>
+#include <vector>
+
+enum ColliderType{
+    NONE,
+    CIRCLE,
+    //Axis-aligned box
+    BOX
+};
+
+//The parts of an object that are set up when it's created or loaded and stay the same for the rest of the level:
+//what it looks like, its collider, and how it's wired to other objects.
+//An object's copies in other timelines, and duplicates of it made when a timeline is pushed, all point at the same
+//definition, so forking a timeline doesn't copy any of this. Only the loaders and the editor should change a definition.
+struct ObjectDefinition
+{
+    ObjectDefinition()
+        : colliderType(NONE)
+        , size(0, 0)
+    {
+    }
+
+    ColliderType colliderType;
+    point_t size;
+
+    //Indexed by ObjectState::animIdx
+    std::vector<sf::Sprite> sprites;
+
+    //Route for enemies to walk when nothing is going on
+    std::vector<point_t> patrolPoints;
+
+    //Switches that toggle a door
+    std::vector<int> connectedSwitches;
+};
+
+#endif
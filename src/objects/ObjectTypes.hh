@@ -0,0 +1,291 @@
+#ifndef __OBJECT_TYPES_HH__
+#define __OBJECT_TYPES_HH__
+
+#include "GameObject.hh"
+#include "Player.hh"
+#include "Bullet.hh"
+#include "Enemy.hh"
+#include "TimeBox.hh"
+#include "Switch.hh"
+#include "Door.hh"
+#include "Closet.hh"
+#include "Turnstile.hh"
+#include "Container.hh"
+#include "Spikes.hh"
+#include "Throwable.hh"
+#include "Objective.hh"
+#include "Knife.hh"
+#include "Gun.hh"
+#include "Exit.hh"
+#include "Crime.hh"
+#include "Alarm.hh"
+#include <utils/ObjectPool.hh>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//Every kind of object, listed once. Anything that used to be a switch over ObjectType by hand
+//(names, copying objects into a new timeline, which list an object goes in, checked casts) is generated from these lists.
+//A new kind of object needs TYPE and TYPE_NAME in its class and an entry in ObjectTypes,
+//plus one in TimelineLists if it shouldn't share a list with its base class.
+template<typename... Ts>
+struct ObjectTypeList
+{
+    //Calls f(std::type_identity<T>()) for each type, in order
+    template<typename F>
+    constexpr static void forEach(F && f)
+    {
+        (f(std::type_identity<Ts>()), ...);
+    }
+
+    //Calls f(std::type_identity<T>()) for the type with this tag. False if there isn't one
+    template<typename F>
+    static bool visit(GameObject::ObjectType type, F && f)
+    {
+        return ((type == Ts::TYPE && (f(std::type_identity<Ts>()), true)) || ...);
+    }
+};
+
+//One concrete class per ObjectType
+typedef ObjectTypeList<Player, Bullet, Enemy, TimeBox, Switch, Door, Closet, Turnstile, Spikes, Objective, Knife, Gun, Exit, Crime, Alarm> ObjectTypes;
+
+namespace object_types{
+    //Which tags belong to T or a class derived from it, so a base like Container can be checked too
+    template<typename T>
+    constexpr std::array<bool, GameObject::N_OBJECT_TYPES> makeTypeTable()
+    {
+        std::array<bool, GameObject::N_OBJECT_TYPES> table{};
+        ObjectTypes::forEach([&]<typename U>(std::type_identity<U>)
+        {
+            table[U::TYPE] = std::is_base_of_v<T, U>;
+        });
+        return table;
+    }
+
+    template<typename T>
+    constexpr std::array<bool, GameObject::N_OBJECT_TYPES> TYPE_TABLE = makeTypeTable<T>();
+
+    template<typename T>
+    bool isType(GameObject::ObjectType type)
+    {
+        return type >= 0 && type < GameObject::N_OBJECT_TYPES && TYPE_TABLE<T>[type];
+    }
+}//end namespace object_types
+
+//Like dynamic_cast, but only looks at the object's tag. Null if obj isn't a T
+template<typename T>
+T* objectCast(GameObject* obj)
+{
+    if(obj == nullptr || !object_types::isType<T>(obj->type()))
+    {
+        return nullptr;
+    }
+    return static_cast<T*>(obj);
+}
+
+//Objects come from a pool for their type, so ones that keep being created and deleted reuse the same memory
+template<typename T, typename... Args>
+std::shared_ptr<T> makeObject(Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+//A copy of obj with a new ID, made with its class's ancestor constructor
+static std::shared_ptr<GameObject> cloneObject(GameObject* obj, int id)
+{
+    std::shared_ptr<GameObject> clone;
+    ObjectTypes::visit(obj->type(), [&]<typename T>(std::type_identity<T>)
+    {
+        clone = makeObject<T>(id, static_cast<T*>(obj));
+    });
+    if(!clone)
+    {
+        throw std::runtime_error("Cannot copy object of type " + GameObject::typeToString(obj->type()));
+    }
+    return clone;
+}
+
+//The part of a component table that's specific to its type. Each specialization says what goes in the column and
+//where it comes from. These are only copied from the object when it joins a timeline: the fields they come from are set
+//when the object is created and never change after that, so the object's own copies are only read by the editor and loaders
+template<typename L>
+struct TypeComponent
+{
+    struct type {};
+
+    static type from(L*)
+    {
+        return type();
+    }
+};
+
+template<>
+struct TypeComponent<Bullet>
+{
+    typedef BulletMotion type;
+
+    static type from(Bullet* bullet)
+    {
+        return BulletMotion{bullet->velocity};
+    }
+};
+
+template<>
+struct TypeComponent<Spikes>
+{
+    typedef SpikesCycle type;
+
+    static type from(Spikes* spikes)
+    {
+        return SpikesCycle{spikes->downDuration, spikes->upDuration, spikes->cycleOffset};
+    }
+};
+
+template<>
+struct TypeComponent<Throwable>
+{
+    typedef ThrowParams type;
+
+    static type from(Throwable* throwable)
+    {
+        return ThrowParams{throwable->throwSpeed, throwable->drag, throwable->bounciness, throwable->useDuration};
+    }
+};
+
+//Dense per-type storage for a timeline's objects. Row i of every column belongs to objects[i], in the order the timeline goes through them.
+//An object's states live here while it's in the table (GameObject::state() points into states), so the tick passes
+//that go through every object of a type read contiguous arrays instead of following each object's pointer
+template<typename L>
+struct ComponentTable
+{
+    typedef typename TypeComponent<L>::type Component;
+
+    ComponentTable() {}
+
+    //Objects point into the columns, which a copy wouldn't keep up to date. Moving keeps the same storage
+    ComponentTable(const ComponentTable&) = delete;
+    ComponentTable& operator=(const ComponentTable&) = delete;
+    ComponentTable(ComponentTable&&) = default;
+    ComponentTable& operator=(ComponentTable&&) = default;
+
+    //A timeline's objects are destroyed after its tables, and may be held onto elsewhere, so they get their states back
+    ~ComponentTable()
+    {
+        for(L* obj : objects)
+        {
+            obj->detachStates();
+        }
+    }
+
+    size_t size() const
+    {
+        return objects.size();
+    }
+
+    void add(L* obj)
+    {
+        const StateBuffer* oldData = states.data();
+        objects.push_back(obj);
+        states.push_back(obj->stateBuffer());
+        components.push_back(TypeComponent<L>::from(obj));
+        if(states.data() != oldData)
+        {
+            reattach(0);
+        }
+        else
+        {
+            obj->attachStates(&states.back());
+        }
+    }
+
+    //Rows keep their order, since some passes depend on it
+    bool remove(L* obj)
+    {
+        auto it = std::find(objects.begin(), objects.end(), obj);
+        if(it == objects.end())
+        {
+            return false;
+        }
+        size_t row = it - objects.begin();
+        obj->detachStates();
+        objects.erase(it);
+        states.erase(states.begin() + row);
+        components.erase(components.begin() + row);
+        reattach(row);
+        return true;
+    }
+
+    std::vector<L*> objects;
+    std::vector<StateBuffer> states;
+    std::vector<Component> components;
+
+private:
+    //Point objects from this row on at their rows again after the storage has moved
+    void reattach(size_t firstRow)
+    {
+        for(size_t i = firstRow; i < objects.size(); i++)
+        {
+            objects[i]->attachStates(&states[i]);
+        }
+    }
+};
+
+//A component table for each of Ls, in the order a timeline goes through them.
+//Each object goes in the first table whose type it is or derives from
+template<typename... Ls>
+struct ObjectLists
+{
+    template<typename L>
+    ComponentTable<L> & table()
+    {
+        return std::get<ComponentTable<L>>(tables);
+    }
+
+    template<typename L>
+    const ComponentTable<L> & table() const
+    {
+        return std::get<ComponentTable<L>>(tables);
+    }
+
+    template<typename L>
+    std::vector<L*> & get()
+    {
+        return table<L>().objects;
+    }
+
+    template<typename L>
+    const std::vector<L*> & get() const
+    {
+        return table<L>().objects;
+    }
+
+    //False if no table takes this type
+    bool add(GameObject* obj)
+    {
+        return ((object_types::isType<Ls>(obj->type()) && (table<Ls>().add(static_cast<Ls*>(obj)), true)) || ...);
+    }
+
+    bool remove(GameObject* obj)
+    {
+        return ((object_types::isType<Ls>(obj->type()) && (table<Ls>().remove(static_cast<Ls*>(obj)), true)) || ...);
+    }
+
+    //Calls f with each list of objects, in order
+    template<typename F>
+    void forEach(F && f) const
+    {
+        (f(get<Ls>()), ...);
+    }
+
+    std::tuple<ComponentTable<Ls>...> tables;
+};
+
+typedef ObjectLists<Player, Bullet, Enemy, Switch, Door, Container, Spikes, Throwable, Exit, Crime, Alarm> TimelineLists;
+
+#endif
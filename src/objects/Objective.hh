@@ -10,8 +10,7 @@ public:
     Objective(int id)
         : Throwable(id)
     {
-        colliderType = CIRCLE;
-        size = point_t(10, 10);
+        setCollider(CIRCLE, point_t(10, 10));
         setupSprites({"trophy.png"});
     }
 
@@ -20,9 +19,12 @@ public:
     {
     }
 
+    constexpr static ObjectType TYPE = OBJECTIVE;
+    constexpr static const char * TYPE_NAME = "objective";
+
     ObjectType type() override
     {
-        return OBJECTIVE;
+        return TYPE;
     }
 };
 
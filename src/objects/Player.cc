@@ -5,10 +5,10 @@ Player::Player(int id)
     : GameObject(id)
     , moveSpeed(1.5)
     , fireCooldown(60)
+    , m_observations(std::make_shared<std::vector<ObservationFrame>>())
 {
 
-    colliderType = CIRCLE;
-    size = point_t(10, 10);
+    setCollider(CIRCLE, point_t(10, 10));
     setupSprites({"smiley.png"});
 }
 
@@ -16,5 +16,6 @@ Player::Player(int id, Player* ancestor)
     : GameObject(id, ancestor)
     , moveSpeed(ancestor->moveSpeed)
     , fireCooldown(ancestor->fireCooldown)
+    , m_observations(std::make_shared<std::vector<ObservationFrame>>())
 {
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "GameObject.hh"
 
+#include <memory>
+
 class Player : public GameObject
 {
 public:
@@ -14,9 +16,12 @@ public:
     Player(int id);
     Player(int id, Player* ancestor);
 
+    constexpr static ObjectType TYPE = PLAYER;
+    constexpr static const char * TYPE_NAME = "player";
+
     ObjectType type() override
     {
-        return PLAYER;
+        return TYPE;
     }
 
     float moveSpeed;
@@ -32,7 +37,29 @@ public:
     };
     typedef std::vector<Observation> ObservationFrame;
 
-    std::vector<ObservationFrame> observations;
+    const std::vector<ObservationFrame> & observations() const
+    {
+        return *m_observations;
+    }
+
+    //Copies the observations first if a copy of this player in another timeline is still sharing them
+    std::vector<ObservationFrame> & editObservations()
+    {
+        if(m_observations.use_count() > 1)
+        {
+            m_observations = std::make_shared<std::vector<ObservationFrame>>(*m_observations);
+        }
+        return *m_observations;
+    }
+
+    //For copies of a player in a new timeline, which only ever read what the original observed
+    void shareObservations(const Player * other)
+    {
+        m_observations = other->m_observations;
+    }
+
+private:
+    std::shared_ptr<std::vector<ObservationFrame>> m_observations;
 };
 
 #endif
\ No newline at end of file
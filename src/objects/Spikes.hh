@@ -3,6 +3,14 @@
 
 #include "GameObject.hh"
 
+//What evaluateSpikes needs besides the spikes' state, kept in the timeline's spikes table
+struct SpikesCycle
+{
+    int downDuration;
+    int upDuration;
+    int cycleOffset;
+};
+
 class Spikes : public GameObject
 {
 public:
@@ -21,8 +29,7 @@ public:
         , upDuration(0)
         , cycleOffset(0)
     {
-        colliderType = BOX;
-        size = point_t(20, 20);
+        setCollider(BOX, point_t(20, 20));
         setupSprites({"spikes_down.png", "spikes_warning.png", "spikes_up.png"});
     }
 
@@ -32,8 +39,7 @@ public:
         , upDuration(_upDuration)
         , cycleOffset(_cycleOffset)
     {
-        colliderType = BOX;
-        size = point_t(20, 20);
+        setCollider(BOX, point_t(20, 20));
         setupSprites({"spikes_down.png", "spikes_warning.png", "spikes_up.png"});
     }
 
@@ -45,9 +51,17 @@ public:
     {
     }
 
+    constexpr static ObjectType TYPE = SPIKES;
+    constexpr static const char * TYPE_NAME = "spikes";
+
     ObjectType type() override
     {
-        return SPIKES;
+        return TYPE;
+    }
+
+    bool isAnalytic() override
+    {
+        return true;
     }
 
     int downDuration;
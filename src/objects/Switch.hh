@@ -15,8 +15,7 @@ public:
     Switch(int id)
         : GameObject(id)
     {
-        colliderType = BOX;
-        size = point_t(8, 8);
+        setCollider(BOX, point_t(8, 8));
         setupSprites({"switchon.png", "switchoff.png"});
     }
 
@@ -25,9 +24,17 @@ public:
     {
     }
 
+    constexpr static ObjectType TYPE = SWITCH;
+    constexpr static const char * TYPE_NAME = "switch";
+
     ObjectType type() override
     {
-        return SWITCH;
+        return TYPE;
+    }
+
+    bool canSleep() override
+    {
+        return true;
     }
 };
 
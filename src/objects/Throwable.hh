@@ -3,6 +3,15 @@
 
 #include "GameObject.hh"
 
+//What tickThrowable needs besides the throwable's state, kept in the timeline's throwable table
+struct ThrowParams
+{
+    float throwSpeed;
+    float drag;
+    float bounciness;
+    int useDuration;
+};
+
 class Throwable : public GameObject
 {
 public:
@@ -33,6 +42,12 @@ public:
     {
     }
 
+    //Only something lying on the ground stays put until a player picks it up
+    bool canSleep() override
+    {
+        return state().aiState == STILL;
+    }
+
     //Initial speed when thrown
     float throwSpeed;
     //Speed lost per tick
@@ -12,8 +12,7 @@ public:
     TimeBox(int id)
         : Container(id, true, true)
     {
-        colliderType = BOX;
-        size = point_t(25, 25);
+        setCollider(BOX, point_t(25, 25));
         setupSprites({"box.png"});
     }
 
@@ -22,9 +21,12 @@ public:
     {
     }
 
+    constexpr static ObjectType TYPE = TIMEBOX;
+    constexpr static const char * TYPE_NAME = "timebox";
+
     ObjectType type() override
     {
-        return TIMEBOX;
+        return TYPE;
     }
 };
 
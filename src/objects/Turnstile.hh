@@ -12,8 +12,7 @@ public:
     Turnstile(int id)
         : Container(id, true, false)
     {
-        colliderType = BOX;
-        size = point_t(25, 25);
+        setCollider(BOX, point_t(25, 25));
         setupSprites({"turnstile.png"});
     }
 
@@ -22,9 +21,12 @@ public:
     {
     }
 
+    constexpr static ObjectType TYPE = TURNSTILE;
+    constexpr static const char * TYPE_NAME = "turnstile";
+
     ObjectType type() override
     {
-        return TURNSTILE;
+        return TYPE;
     }
 };
 
@@ -12,7 +12,7 @@ bool isVisible(GameState * state, Player * player, GameObject * obj, int tick)
     {
         return false;
     }
-    if(obj->state.visible == false)
+    if(obj->state().visible == false)
     {
         return false;
     }
@@ -20,19 +20,19 @@ bool isVisible(GameState * state, Player * player, GameObject * obj, int tick)
     {
         return false;
     }
-    if(state->level->tileAt(obj->state.pos) == Level::WALL)
+    if(state->level->tileAt(obj->state().pos) == Level::WALL)
     {
         //This is to prevent players from seeing things that are slightly clipped
         //into the *other* side of a wall
         return false;
     }
 
-    point_t levelCoords = state->level->toLevelCoords(obj->state.pos);
+    point_t levelCoords = state->level->toLevelCoords(obj->state().pos);
     if(!state->level->levelCoordsInBounds(levelCoords))
     {
         return false;
     }
-    return state->visibilityGrids[player->id][levelCoords.x][levelCoords.y];
+    return state->visibilityGrids.at(player->id)[levelCoords.x][levelCoords.y];
 }
 
 void recordObservations(GameState * state, Player * player, int tick)
@@ -42,19 +42,20 @@ void recordObservations(GameState * state, Player * player, int tick)
         throw std::runtime_error("Shouldn't be recording observations for a recorded player!");
     }
 
-    if(player->observations.size() < tick)
+    std::vector<Player::ObservationFrame> & observations = player->editObservations();
+    if(observations.size() < tick)
     {
         throw std::runtime_error("Player observation buffer is smaller than expected!");
     }
-    if(player->observations.size() == tick)
+    if(observations.size() == tick)
     {
-        player->observations.push_back(Player::ObservationFrame());
+        observations.push_back(Player::ObservationFrame());
     }
-    Player::ObservationFrame & frame = player->observations[tick];
+    Player::ObservationFrame & frame = observations[tick];
     frame.clear();
 
     //Player can't see anything if they're in a box
-    if(player->state.boxOccupied)
+    if(player->state().boxOccupied)
     {
         return;
     }
@@ -65,7 +66,7 @@ void recordObservations(GameState * state, Player * player, int tick)
 
         if(isVisible(state, player, obj, tick))
         {
-            frame.push_back({obj->type(), obj->state, obj->id});
+            frame.push_back({obj->type(), obj->state(), obj->id});
         }
     }
 
@@ -100,21 +101,21 @@ void printObservations(int playerID, const Player::ObservationFrame & frame, Pla
     std::cout << std::endl;
 }
 
-std::string checkObservations(GameState * state, Player * player, int tick)
+std::string checkObservations(GameState * state, Player * player, int tick, bool printMismatch)
 {
-    if(player->state.boxOccupied)
+    if(player->state().boxOccupied)
     {
         return "";
     }
 
     std::string result = "";
-    if(player->observations.size() <= tick)
+    if(player->observations().size() <= tick)
     {
         throw std::runtime_error("Tried to check observations player " + std::to_string(player->id) + 
-            " at tick " + std::to_string(tick) + " but observation buffer was only " + std::to_string(player->observations.size()) + " long");
+            " at tick " + std::to_string(tick) + " but observation buffer was only " + std::to_string(player->observations().size()) + " long");
     }
 
-    const Player::ObservationFrame & frame = player->observations[tick];
+    const Player::ObservationFrame & frame = player->observations()[tick];
     Player::ObservationFrame actual;
 
     std::map<int, bool> found;
@@ -124,12 +125,12 @@ std::string checkObservations(GameState * state, Player * player, int tick)
 
         if(isVisible(state, player, obj, tick))
         {
-            actual.push_back({obj->type(), obj->state, obj->id});
+            actual.push_back({obj->type(), obj->state(), obj->id});
 
             bool matched = false;
             for(int i=0; i<frame.size(); i++)
             {
-                if(frame[i].type == obj->type() && observablyEqual(frame[i].state, obj->state))
+                if(frame[i].type == obj->type() && observablyEqual(frame[i].state, obj->state()))
                 {
                     found[i] = true;
                     matched = true;
@@ -156,7 +157,7 @@ std::string checkObservations(GameState * state, Player * player, int tick)
         }
     }
 
-    if(result != "")
+    if(result != "" && printMismatch)
     {
         printObservations(player->id, frame, actual, tick);
     }
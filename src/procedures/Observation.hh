@@ -14,7 +14,9 @@ void recordObservations(GameState * state, Player * player, int tick);
 
 bool observablyEqual(const ObjectState & a, const ObjectState & b);
 
-std::string checkObservations(GameState * state, Player * player, int tick);
+//Returns a description of the first mismatch, or an empty string if the player's observations still hold
+//If printMismatch is set, the expected and actual observations are printed when they don't match
+std::string checkObservations(GameState * state, Player * player, int tick, bool printMismatch);
 
 }//namespace observation
 
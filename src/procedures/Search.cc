@@ -1,5 +1,7 @@
 #include "Search.hh"
 
+#include <state/WallVisibility.hh>
+
 namespace search{
 
 VisibilityGrid createVisibilityGrid(GameState * state, point_t center, float startAngle_deg, float endAngle_deg, float distanceLimit)
@@ -26,15 +28,13 @@ VisibilityGrid createVisibilityGrid(GameState * state, point_t center, float sta
     {
         grid[(size_t)center_level.x][(size_t)center_level.y] = true;
     }
-    float startAngle_rad = startAngle_deg * M_PI / 180.0;
-    float endAngle_rad = endAngle_deg * M_PI / 180.0;
-    float increment = (endAngle_rad - startAngle_rad) / N_RAYCASTS;
+    float increment = (endAngle_deg - startAngle_deg) / N_RAYCASTS;
 
     for(int i = 0; i < N_RAYCASTS; i++)
     {
-        float angle = startAngle_rad + (i * increment);
+        float angle = startAngle_deg + (i * increment);
 
-        point_t delta = point_t(DELTA_SIZE * cos(angle), DELTA_SIZE * sin(angle));
+        point_t delta = point_t(DELTA_SIZE * trig::cosDeg(angle), DELTA_SIZE * trig::sinDeg(angle));
         point_t current = center_level;
         int n = 0;
         while(math_util::dist(center_level, current) < DISTANCE_LIMIT)
@@ -91,16 +91,16 @@ VisibilityGrid createVisibilityGrid(GameState * state, point_t center, float sta
 
 VisibilityGrid playerVisibilityGrid(GameState * state, Player * player)
 {
-    if(player->state.boxOccupied)
+    if(player->state().boxOccupied)
     {
         return VisibilityGrid(state->level->width, std::vector<bool>(state->level->height, false));
     }
 
     return createVisibilityGrid(
         state,
-        player->state.pos,
-        player->state.angle_deg - Player::HALF_VIEW_ANGLE,
-        player->state.angle_deg + Player::HALF_VIEW_ANGLE,
+        player->state().pos,
+        player->state().angle_deg - Player::HALF_VIEW_ANGLE,
+        player->state().angle_deg + Player::HALF_VIEW_ANGLE,
         Player::VIEW_RADIUS);
 }
 
@@ -111,7 +111,7 @@ VisibilityGrid createObstructionGrid(GameState * state)
     {
         for(int y = 0; y < state->level->height; y++)
         {
-            grid[x][y] = state->level->tiles[x][y].type == Level::WALL;
+            grid[x][y] = state->level->tile(x, y).type == Level::WALL;
         }
     }
     for(auto pair: state->objects())
@@ -119,7 +119,7 @@ VisibilityGrid createObstructionGrid(GameState * state)
         GameObject * obj = pair.second.get();
         if(obj->isObstruction())
         {
-            point_t levelCoords = state->level->toLevelCoords(obj->state.pos);
+            point_t levelCoords = state->level->toLevelCoords(obj->state().pos);
             grid[levelCoords.x][levelCoords.y] = true;
         }
     }
@@ -138,15 +138,15 @@ bool checkObstruction(GameState * state, point_t pos)
 
 bool checkVisibility(GameState * state, point_t start, point_t dest)
 {
-    const Level::NavNode* startNode = state->level->nodeAt(start);
-    const Level::NavNode* destNode = state->level->nodeAt(dest);
+    int startCell = state->level->cellIndexAt(start);
+    int destCell = state->level->cellIndexAt(dest);
 
-    if(startNode == nullptr || destNode == nullptr)
+    if(startCell < 0 || destCell < 0)
     {
         return false;
     }
 
-    if(startNode->id == destNode->id)
+    if(startCell == destCell)
     {
         return true;
     }
@@ -158,6 +158,44 @@ bool checkVisibility(GameState * state, point_t start, point_t dest)
         return true;
     }
 
+    //Doors are the only obstructions, and only the ones near the line can get in the way
+    std::vector<Door*> obstructions;
+    point_t lineMin(std::min(start.x, dest.x) - DELTA_SIZE, std::min(start.y, dest.y) - DELTA_SIZE);
+    point_t lineMax(std::max(start.x, dest.x) + DELTA_SIZE, std::max(start.y, dest.y) + DELTA_SIZE);
+    for(Door* door : state->doors())
+    {
+        if(!door->isObstruction())
+        {
+            continue;
+        }
+        point_t halfSize;
+        if(door->colliderType() == BOX)
+        {
+            halfSize = door->size() / 2.0f;
+        }
+        else if(door->colliderType() == CIRCLE)
+        {
+            halfSize = point_t(door->radius(), door->radius());
+        }
+        else
+        {
+            continue;
+        }
+        point_t pos = door->state().pos;
+        if(pos.x + halfSize.x >= lineMin.x && pos.x - halfSize.x <= lineMax.x && pos.y + halfSize.y >= lineMin.y && pos.y - halfSize.y <= lineMax.y)
+        {
+            obstructions.push_back(door);
+        }
+    }
+
+    //If the walls can't be in the way either, there's nothing left to step along the line for
+    const WallVisibility * walls = state->level->wallVisibility.get();
+    bool wallsClear = walls != nullptr && walls->clear(start, dest);
+    if(wallsClear && obstructions.empty())
+    {
+        return true;
+    }
+
     point_t delta = math_util::normalize(dest - start) * DELTA_SIZE;
 
     point_t current = start;
@@ -168,24 +206,23 @@ bool checkVisibility(GameState * state, point_t start, point_t dest)
         {
             return true;
         }
-        //TODO the performance of this seems bad, improve later
-        for(const auto & objpair: state->objects())
+        for(Door* door : obstructions)
         {
-            if(objpair.second->isObstruction() && objpair.second->isColliding(current))
+            if(door->isColliding(current))
             {
                 return false;
             }
         }
-        const Level::NavNode* node = state->level->nodeAt(current);
-        if(node == nullptr)
+        int cell = state->level->cellIndexAt(current);
+        if(cell < 0)
         {
             return false;
         }
-        if(node->id == destNode->id)
+        if(cell == destCell)
         {
             return true;
         }
-        if(state->level->tileAt(current) == Level::WALL)
+        if(!wallsClear && state->level->tiles[cell].type == Level::WALL)
         {
             return false;
         }
@@ -206,8 +243,8 @@ bool checkVisibility(GameState * state, point_t start, float start_radius, point
 {
     
     float angle = math_util::angleBetween(start, dest_center);
-    point_t orthogonalVector1 = math_util::normalize(point_t(cos((angle * M_PI/180.0) + M_PI_2), sin((angle * M_PI/180.0) + M_PI_2)));
-    point_t orthogonalVector2 = math_util::normalize(point_t(cos((angle * M_PI/180.0) - M_PI_2), sin((angle * M_PI/180.0) - M_PI_2)));
+    point_t orthogonalVector1 = math_util::normalize(point_t(trig::cosDeg(angle + 90), trig::sinDeg(angle + 90)));
+    point_t orthogonalVector2 = math_util::normalize(point_t(trig::cosDeg(angle - 90), trig::sinDeg(angle - 90)));
 
     bool result = false;
     //Make three checks, one between the centers and two along tangent lines
@@ -232,8 +269,11 @@ point_t navigate(GameState * state, const point_t & start, const point_t & end,
         return start;
     }
 
-    Level::Tile& startTile = state->level->tiles[(int)startX][(int)startY];
-    Level::Tile& endTile = state->level->tiles[(int)endX][(int)endY];
+    const Level * level = state->level.get();
+    int startCell = level->cellIndex((int)startX, (int)startY);
+    int endCell = level->cellIndex((int)endX, (int)endY);
+    const Level::Tile& startTile = level->tiles[startCell];
+    const Level::Tile& endTile = level->tiles[endCell];
 
     if (startTile.type == Level::WALL) {
         std::cout << "Start position is a wall. Cannot navigate!" << std::endl;
@@ -245,15 +285,27 @@ point_t navigate(GameState * state, const point_t & start, const point_t & end,
         return start;
     }
 
-    if(startTile.node.id == endTile.node.id) {
+    if(startCell == endCell) {
         //Within the same tile, can just go directly there
         return end;
     }
 
     //Dijkstra's algorithm
-    std::map<int, float> dist;
+    //Distances are indexed by cell, and only meaningful where visited is set
+    std::vector<float> dist(level->tiles.size());
+    std::vector<char> visited(level->tiles.size(), false);
+    //Shortest length each cell has been expanded with
+    std::vector<float> expandedLength(level->tiles.size(), std::numeric_limits<float>::max());
     std::priority_queue<Level::NavMove> queue;
-    queue.push({&startTile.node, 0.0f});
+    queue.push({startCell, 0.0f, 0.0f});
+
+    //Closed doors are the only obstructions that aren't walls, and the walls are already left out of the nav mesh.
+    //Their cost only makes routes around them preferable. It doesn't count against maxDistance, so a cell settled
+    //by a long route around a door is expanded again if a shorter route through the door reaches it,
+    //and everything within maxDistance of the start is still reachable with the door closed
+    const VisibilityGrid & obstructions = state->obstructionGrid;
+    bool checkDoors = obstructions.size() == level->width;
+    float closedDoorCost = CLOSED_DOOR_COST * level->scale;
 
     bool found = false;
 
@@ -263,27 +315,42 @@ point_t navigate(GameState * state, const point_t & start, const point_t & end,
         Level::NavMove move = queue.top();
         queue.pop();
 
-        if(dist.find(move.node->id) != dist.end()) {
-            //Already visited
+        if(visited[move.cell] && move.length >= expandedLength[move.cell]) {
+            //Already visited, and this way isn't any shorter
             continue;
         }
-        dist[move.node->id] = move.dist;
-        //std::cout << move.node->pos.x << ", " << move.node->pos.y << ": " << move.dist << std::endl;
+        if(!visited[move.cell]) {
+            visited[move.cell] = true;
+            dist[move.cell] = move.dist;
+        }
+        expandedLength[move.cell] = move.length;
 
-        if (move.node->id == endTile.node.id) {
+        if (move.cell == endCell) {
             found = true;
             break;
         }
 
-        for (Level::NavNode* neighbor : move.node->neighbors) {
-            float newDist = dist[move.node->id] + math_util::dist(move.node->pos, neighbor->pos);
-            if(newDist > maxDistance)
+        point_t movePos = level->cellCenter(move.cell);
+        uint8_t neighbors = level->tiles[move.cell].neighbors;
+        for (int dir = 0; dir < Level::N_DIRECTIONS; dir++) {
+            if (!(neighbors & (1 << dir))) {
+                continue;
+            }
+            int neighbor = level->neighborIndex(move.cell, dir);
+            float step = math_util::dist(movePos, level->cellCenter(neighbor));
+            float newDist = move.dist + step;
+            float newLength = move.length + step;
+            if(checkDoors && obstructions[level->cellX(neighbor)][level->cellY(neighbor)])
+            {
+                newDist += closedDoorCost;
+            }
+            if(newLength > maxDistance)
             {
                 continue;
             }
 
-            if (dist.find(neighbor->id) == dist.end()) {
-                queue.push({neighbor, newDist});
+            if (!visited[neighbor] || newLength < expandedLength[neighbor]) {
+                queue.push({neighbor, newDist, newLength});
             }
         }
         iterations++;
@@ -304,22 +371,26 @@ point_t navigate(GameState * state, const point_t & start, const point_t & end,
     else {
         //std::cout << "Navigate: backtrace" << std::endl;
         //Note: this backtrace assumes that being neighbors is reciprocal
-        Level::NavNode* current = &endTile.node;
+        int current = endCell;
         while (true) {
-            //std::cout << current->pos.x << ", " << current->pos.y << std::endl;
             float minDist = std::numeric_limits<float>::max();
-            Level::NavNode* next = nullptr;
-            for (Level::NavNode* neighbor : current->neighbors) {
-                if (dist.find(neighbor->id) != dist.end() && dist[neighbor->id] < minDist) {
-                    minDist = dist[neighbor->id];
+            int next = -1;
+            uint8_t neighbors = level->tiles[current].neighbors;
+            for (int dir = 0; dir < Level::N_DIRECTIONS; dir++) {
+                if (!(neighbors & (1 << dir))) {
+                    continue;
+                }
+                int neighbor = level->neighborIndex(current, dir);
+                if (visited[neighbor] && dist[neighbor] < minDist) {
+                    minDist = dist[neighbor];
                     next = neighbor;
                 }
             }
-            if(next == nullptr) {
+            if(next < 0) {
                 throw std::runtime_error("Navigation backtrace failed! This shouldn't happen!");
             }
-            if(next->id == startTile.node.id) {
-                return current->pos;
+            if(next == startCell) {
+                return level->cellCenter(current);
             }
             current = next;
 
@@ -336,8 +407,8 @@ point_t navigate(GameState * state, const point_t & start, const point_t & end,
 
 float bounceOffWall(GameState * state, const point_t & startPoint, const point_t & obstructedPoint)
 {
-    point_t startTilePos = state->level->nodeAt(startPoint)->pos;
-    point_t obstructedTilePos = state->level->nodeAt(obstructedPoint)->pos;
+    point_t startTilePos = state->level->cellCenter(state->level->cellIndexAt(startPoint));
+    point_t obstructedTilePos = state->level->cellCenter(state->level->cellIndexAt(obstructedPoint));
 
     if(startTilePos == obstructedTilePos)
     {
@@ -9,6 +9,10 @@ namespace search {
 
 const float UNLIMITED_DISTANCE = 1e12;
 
+//Extra cost of walking into a closed door's tile, in tiles. Enough that any sensible way around is better,
+//but the door is still a way through, since it might be open by the time anyone gets there
+const float CLOSED_DOOR_COST = 100;
+
 VisibilityGrid createVisibilityGrid(GameState * state, point_t center, float startAngle_deg, float endAngle_deg, float distanceLimit);
 
 VisibilityGrid playerVisibilityGrid(GameState * state, Player * player);
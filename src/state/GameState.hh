@@ -2,180 +2,706 @@
 #define __GAMESTATE_HH__
 
 #include "Level.hh"
-#include "objects/Player.hh"
-#include "objects/Bullet.hh"
-#include "objects/Enemy.hh"
-#include "objects/TimeBox.hh"
-#include "objects/Switch.hh"
-#include "objects/Door.hh"
-#include "objects/Closet.hh"
-#include "objects/Turnstile.hh"
-#include "objects/Container.hh"
-#include "objects/Spikes.hh"
-#include "objects/Throwable.hh"
-#include "objects/Objective.hh"
-#include "objects/Knife.hh"
-#include "objects/Gun.hh"
-#include "objects/Exit.hh"
-#include "objects/Crime.hh"
-#include "objects/Alarm.hh"
-#include <objects/GameObject.hh>
+#include "objects/ObjectTypes.hh"
 #include "Promise.hh"
+#include "VisibilityCache.hh"
+#include "ThreatMap.hh"
 
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
-struct HistoryBuffer
+//One object's state on every tick it has been recorded for.
+//Each tick holds an index into a pool of distinct states, so a run of ticks where the object
+//didn't change (e.g. while it was asleep) shares one state instead of storing a copy per tick.
+//Ticks are kept in fixed-size chunks that are shared between copies of the history, and a chunk is only copied
+//when one of them writes to it. A timeline starts with a copy of its parent's histories,
+//so it only pays for the ticks it actually changes.
+//Chunks where every tick still has the default state aren't stored at all, so an object created late
+//only pays for the ticks from about its beginning onwards.
+class ObjectHistory
 {
-    HistoryBuffer()
-        : breakpoint(0)
+public:
+    constexpr static int CHUNK_BITS = 8;
+    constexpr static int CHUNK_TICKS = 1 << CHUNK_BITS;
+
+    ObjectHistory()
+        : m_size(0)
     {
     }
 
-    HistoryBuffer(const HistoryBuffer& other, int breakpoint)
-        : buffer(other.buffer)
-        , breakpoint(breakpoint)
+    //Every tick up to size starts out with a default state
+    ObjectHistory(int size)
+        : m_chunks((size + CHUNK_TICKS - 1) >> CHUNK_BITS)
+        , m_size(size)
     {
     }
 
-    std::vector<ObjectState>& operator[](int i)
+    int size() const
     {
-        if(buffer.find(i) == buffer.end())
+        return m_size;
+    }
+
+    const ObjectState& operator[](int tick) const
+    {
+        const Chunk * chunk = m_chunks[tick >> CHUNK_BITS].get();
+        if(chunk == nullptr)
         {
-            throw std::runtime_error("No buffer for object " + std::to_string(i));
+            static const ObjectState defaultState;
+            return defaultState;
         }
-        return buffer.at(i);
+        return chunk->states[chunk->index[tick & (CHUNK_TICKS - 1)]];
     }
 
-    std::map<int, std::vector<ObjectState>> buffer;
-    int breakpoint;
+    //Record the state for a tick, either overwriting an existing tick or appending the next one
+    void set(int tick, const ObjectState& objState)
+    {
+        int offset = tick & (CHUNK_TICKS - 1);
+        if(tick == size())
+        {
+            if(offset == 0)
+            {
+                m_chunks.push_back(std::make_shared<Chunk>());
+            }
+            Chunk & chunk = writableChunk(tick >> CHUNK_BITS);
+            if(offset > 0 && chunk.states[chunk.index.back()] == objState)
+            {
+                //Still holding the same state as the previous tick
+                chunk.index.push_back(chunk.index.back());
+            }
+            else
+            {
+                chunk.states.push_back(objState);
+                chunk.index.push_back(chunk.states.size() - 1);
+            }
+            m_size++;
+            return;
+        }
+        else if(tick > size() || tick < 0)
+        {
+            throw std::runtime_error("ObjectHistory: Can't set tick " + std::to_string(tick) + " in a history of size " + std::to_string(size()));
+        }
+
+        //Don't copy a shared chunk just to write what's already there
+        if((*this)[tick] == objState)
+        {
+            return;
+        }
+        Chunk & chunk = writableChunk(tick >> CHUNK_BITS);
+        //Join a neighbouring run if it holds the same state
+        if(offset > 0 && chunk.states[chunk.index[offset-1]] == objState)
+        {
+            chunk.index[offset] = chunk.index[offset-1];
+            return;
+        }
+        if(offset + 1 < (int)chunk.index.size() && chunk.states[chunk.index[offset+1]] == objState)
+        {
+            chunk.index[offset] = chunk.index[offset+1];
+            return;
+        }
+
+        //The old state may still be shared with other ticks, so it can't be overwritten in place
+        chunk.states.push_back(objState);
+        chunk.index[offset] = chunk.states.size() - 1;
+
+        //Overwritten states are left behind in the pool, so clear them out once they start to pile up
+        if(chunk.states.size() > 2 * chunk.index.size() + 16)
+        {
+            chunk.compact();
+        }
+    }
+
+private:
+    struct Chunk
+    {
+        void compact()
+        {
+            std::vector<int> remap(states.size(), -1);
+            std::vector<ObjectState> kept;
+            for(size_t i = 0; i < index.size(); i++)
+            {
+                if(remap[index[i]] == -1)
+                {
+                    remap[index[i]] = kept.size();
+                    kept.push_back(states[index[i]]);
+                }
+                index[i] = remap[index[i]];
+            }
+            states = std::move(kept);
+        }
+
+        //Distinct states, referenced by index
+        std::vector<ObjectState> states;
+        //Position in states for each tick in the chunk
+        std::vector<int> index;
+    };
+
+    //Copy the chunk first if another history is still using it, or fill it in if it was all default states
+    Chunk & writableChunk(int chunkIdx)
+    {
+        if(m_chunks[chunkIdx] == nullptr)
+        {
+            m_chunks[chunkIdx] = std::make_shared<Chunk>();
+            m_chunks[chunkIdx]->states.resize(1);
+            m_chunks[chunkIdx]->index.assign(std::min(CHUNK_TICKS, m_size - (chunkIdx << CHUNK_BITS)), 0);
+        }
+        else if(m_chunks[chunkIdx].use_count() > 1)
+        {
+            m_chunks[chunkIdx] = std::make_shared<Chunk>(*m_chunks[chunkIdx]);
+        }
+        return *m_chunks[chunkIdx];
+    }
+
+    std::vector<std::shared_ptr<Chunk>> m_chunks;
+    int m_size;
 };
 
-struct Timeline
+//Spans of ticks where a container's history has it occupied, keyed by their first tick.
+//Kept in step with the container's history so upcoming occupancy can be found without scanning it tick by tick.
+class ContainerOccupancy
 {
-    Timeline() {}
+public:
+    struct Span
+    {
+        int start;
+        //Inclusive
+        int end;
+        int occupant;
+    };
 
-    Timeline(const Timeline& other, int breakpoint, bool playerIsBackwards)
+    //Record the container's occupancy on a tick, in step with its history
+    void set(int tick, const ObjectState& containerState)
     {
-        for(Player* p : other.players)
+        auto it = spanAt(tick);
+        if(it != m_spans.end())
         {
-            std::shared_ptr<Player> newPlayer = std::make_shared<Player>(p->id, p);
-            players.push_back(newPlayer.get());
-            objects[newPlayer->id] = newPlayer;
-            
-            newPlayer->observations = p->observations;
+            if(containerState.boxOccupied && it->second.occupant == containerState.attachedObjectId)
+            {
+                return;
+            }
+            removeTick(it, tick);
         }
-        for(Bullet* b : other.bullets)
+
+        if(!containerState.boxOccupied)
         {
-            std::shared_ptr<Bullet> newBullet = std::make_shared<Bullet>(b->id, b);
-            bullets.push_back(newBullet.get());
-            objects[newBullet->id] = newBullet;
+            return;
         }
-        for(Enemy* e : other.enemies)
+
+        Span span = {tick, tick, containerState.attachedObjectId};
+
+        //Merge with neighbouring spans for the same occupant
+        auto next = m_spans.find(tick + 1);
+        if(next != m_spans.end() && next->second.occupant == span.occupant)
         {
-            std::shared_ptr<Enemy> newEnemy = std::make_shared<Enemy>(e->id, e);
-            enemies.push_back(newEnemy.get());
-            objects[newEnemy->id] = newEnemy;
+            span.end = next->second.end;
+            m_spans.erase(next);
         }
-        for(Switch* s : other.switches)
+        auto prev = spanAt(tick - 1);
+        if(prev != m_spans.end() && prev->second.occupant == span.occupant)
         {
-            std::shared_ptr<Switch> newSwitch = std::make_shared<Switch>(s->id, s);
-            switches.push_back(newSwitch.get());
-            objects[newSwitch->id] = newSwitch;
+            prev->second.end = span.end;
+            return;
         }
-        for(Door* d : other.doors)
+        m_spans[tick] = span;
+    }
+
+    //How many ticks from the given tick, in the direction of time, until someone other than occupant is in the container?
+    //Returns -1 if there is nobody else within maxTicks (exclusive)
+    int ticksUntilOtherOccupant(int tick, int occupant, bool backwards, int maxTicks)
+    {
+        if(backwards)
         {
-            std::shared_ptr<Door> newDoor = std::make_shared<Door>(d->id, d);
-            doors.push_back(newDoor.get());
-            objects[newDoor->id] = newDoor;
+            auto it = m_spans.upper_bound(tick - 1);
+            while(it != m_spans.begin())
+            {
+                it--;
+                int nearest = std::min(it->second.end, tick - 1);
+                if(tick - nearest >= maxTicks)
+                {
+                    return -1;
+                }
+                if(it->second.occupant != occupant)
+                {
+                    return tick - nearest;
+                }
+            }
         }
-        for(Container* c : other.containers)
+        else
         {
-            std::shared_ptr<Container> newContainer;
-            if(c->type() == GameObject::TIMEBOX)
+            auto it = spanAt(tick + 1);
+            if(it == m_spans.end())
             {
-                newContainer = std::make_shared<TimeBox>(c->id, dynamic_cast<TimeBox*>(c));
+                it = m_spans.upper_bound(tick + 1);
             }
-            else if(c->type() == GameObject::CLOSET)
+            for(; it != m_spans.end(); it++)
             {
-                newContainer = std::make_shared<Closet>(c->id, dynamic_cast<Closet*>(c));
+                int nearest = std::max(it->second.start, tick + 1);
+                if(nearest - tick >= maxTicks)
+                {
+                    return -1;
+                }
+                if(it->second.occupant != occupant)
+                {
+                    return nearest - tick;
+                }
             }
-            else if(c->type() == GameObject::TURNSTILE)
+        }
+        return -1;
+    }
+
+private:
+    //The span covering a tick, if any
+    std::map<int, Span>::iterator spanAt(int tick)
+    {
+        auto it = m_spans.upper_bound(tick);
+        if(it == m_spans.begin())
+        {
+            return m_spans.end();
+        }
+        it--;
+        if(it->second.end < tick)
+        {
+            return m_spans.end();
+        }
+        return it;
+    }
+
+    //Cut a single tick out of the span containing it
+    void removeTick(std::map<int, Span>::iterator it, int tick)
+    {
+        Span span = it->second;
+        m_spans.erase(it);
+        if(span.start < tick)
+        {
+            m_spans[span.start] = {span.start, tick - 1, span.occupant};
+        }
+        if(span.end > tick)
+        {
+            m_spans[tick + 1] = {tick + 1, span.end, span.occupant};
+        }
+    }
+
+    std::map<int, Span> m_spans;
+};
+
+struct HistoryBuffer
+{
+    HistoryBuffer()
+        : breakpoint(0)
+    {
+    }
+
+    HistoryBuffer(const HistoryBuffer& other, int breakpoint)
+        : buffer(other.buffer)
+        , occupancy(other.occupancy)
+        , breakpoint(breakpoint)
+    {
+    }
+
+    ObjectHistory& operator[](int i)
+    {
+        if(buffer.find(i) == buffer.end())
+        {
+            throw std::runtime_error("No buffer for object " + std::to_string(i));
+        }
+        return buffer.at(i);
+    }
+
+    std::map<int, ObjectHistory> buffer;
+    //Occupancy spans for each container's history in buffer
+    std::map<int, ContainerOccupancy> occupancy;
+    int breakpoint;
+};
+
+//A set of objects with their history pointers cached, so a pass over them doesn't go through the buffer map
+struct ObjectLane
+{
+    void clear()
+    {
+        objects.clear();
+        histories.clear();
+    }
+
+    void add(GameObject* obj, ObjectHistory* history)
+    {
+        objects.push_back(obj);
+        histories.push_back(history);
+    }
+
+    void remove(int id)
+    {
+        for(size_t i = 0; i < objects.size(); i++)
+        {
+            if(objects[i]->id == id)
             {
-                newContainer = std::make_shared<Turnstile>(c->id, dynamic_cast<Turnstile*>(c));
+                objects.erase(objects.begin() + i);
+                histories.erase(histories.begin() + i);
+                return;
             }
-            else
+        }
+    }
+
+    //Only objects that exist on this tick can be written to, so only they need a fresh next state
+    void prepare(int tick)
+    {
+        for(GameObject* obj : objects)
+        {
+            if(obj->activeAt(tick) && !obj->asleep)
             {
-                throw std::runtime_error("Unknown container type " + GameObject::typeToString(c->type()));
+                obj->prepareNextState();
             }
-            containers.push_back(newContainer.get());
-            objects[newContainer->id] = newContainer;
         }
-        for(Spikes* s : other.spikes)
+    }
+
+    std::vector<GameObject*> objects;
+    std::vector<ObjectHistory*> histories;
+};
+
+//Objects whose state in the current timeline comes straight from history:
+//recorded players, and anything moving in the opposite direction to the timeline.
+//Other objects' ticks can still write to them, so they're prepared like simulated ones
+struct ReplayLane : ObjectLane
+{
+    void restore(int tick)
+    {
+        for(size_t i = 0; i < objects.size(); i++)
         {
-            std::shared_ptr<Spikes> newSpikes = std::make_shared<Spikes>(s->id, s);
-            spikes.push_back(newSpikes.get());
-            objects[newSpikes->id] = newSpikes;
+            GameObject* obj = objects[i];
+            if(!obj->activeAt(tick))
+            {
+                continue;
+            }
+            if(tick >= histories[i]->size())
+            {
+                throw std::runtime_error("ReplayLane: It is tick " + std::to_string(tick) + " but object " + std::to_string(obj->id) + " has history buffer size " + std::to_string(histories[i]->size()));
+            }
+            obj->state() = (*histories[i])[tick];
         }
-        for(Throwable* t : other.throwables)
+    }
+};
+
+//Objects simulated in the current timeline: everything that isn't replayed from history or analytic.
+//The passes over every object at the start and end of a tick go through this instead of the object map
+struct SimLane : ObjectLane
+{
+    //Apply next states to current states and record them
+    void commit(int tick)
+    {
+        for(size_t i = 0; i < objects.size(); i++)
         {
-            std::shared_ptr<Throwable> newThrowable;
-            if(t->type() == GameObject::OBJECTIVE)
+            GameObject* obj = objects[i];
+            if(!obj->activeAt(tick))
             {
-                newThrowable = std::make_shared<Objective>(t->id, dynamic_cast<Objective*>(t));
+                continue;
             }
-            else if(t->type() == GameObject::KNIFE)
+
+            //Sleeping objects kept their state, so all they need is to extend its run in history
+            if(!obj->asleep)
             {
-                newThrowable = std::make_shared<Knife>(t->id, dynamic_cast<Knife*>(t));
+                obj->applyNextState();
+
+                //After the swap nextState holds the state from before this tick
+                obj->asleep = obj->canSleep() && obj->state() == obj->nextState();
             }
-            else if(t->type() == GameObject::GUN)
+
+            if(tick > histories[i]->size())
             {
-                newThrowable = std::make_shared<Gun>(t->id, dynamic_cast<Gun*>(t));
+                throw std::runtime_error("SimLane: It is tick " + std::to_string(tick) + " but object " + std::to_string(obj->id) + " has history buffer size " + std::to_string(histories[i]->size()));
             }
-            else
+            histories[i]->set(tick, obj->state());
+        }
+    }
+};
+
+//Compiled switch -> door connections.
+//Edges are indexed so updating doesn't go through the object map, and a door is only
+//re-evaluated when one of its switches has actually changed.
+struct SignalGraph
+{
+    void clear()
+    {
+        switches.clear();
+        histories.clear();
+        switchOn.clear();
+        switchDoors.clear();
+        switchIndex.clear();
+        doors.clear();
+        onCount.clear();
+        doorDirty.clear();
+    }
+
+    //Add all switches before any doors, so doors can be linked to them
+    void addSwitch(Switch* sw, ObjectHistory* history)
+    {
+        switchIndex[sw->id] = switches.size();
+        switches.push_back(sw);
+        histories.push_back(history);
+        switchOn.push_back(false);
+        switchDoors.push_back(std::vector<int>());
+    }
+
+    void addDoor(Door* door)
+    {
+        int doorIdx = doors.size();
+        doors.push_back(door);
+        onCount.push_back(0);
+        //Every door needs evaluating once, even if its switches never change
+        doorDirty.push_back(true);
+
+        for(int swId : door->getConnectedSwitches())
+        {
+            auto it = switchIndex.find(swId);
+            if(it == switchIndex.end())
             {
-                throw std::runtime_error("Unknown throwable type " + GameObject::typeToString(t->type()));
+                continue;
             }
-            throwables.push_back(newThrowable.get());
-            objects[newThrowable->id] = newThrowable;
+            switchDoors[it->second].push_back(doorIdx);
         }
-        for(Exit* e : other.exits)
+    }
+
+    //Bring doors up to date with their switches' recorded states on the given tick
+    void update(int switchTick)
+    {
+        for(size_t i = 0; i < switches.size(); i++)
         {
-            std::shared_ptr<Exit> newExit = std::make_shared<Exit>(e->id, e);
-            exits.push_back(newExit.get());
-            objects[newExit->id] = newExit;
+            if(switchTick >= histories[i]->size())
+            {
+                throw std::runtime_error("SignalGraph: No history for switch " + std::to_string(switches[i]->id) + " on tick " + std::to_string(switchTick));
+            }
+            setSwitch(i, (*histories[i])[switchTick].aiState == Switch::ON);
         }
+        updateDoors();
+    }
 
-        for(Crime* c : other.crimes)
+    //Bring doors up to date with their switches' current states. For the editor, where switches have no history
+    void updateLive()
+    {
+        for(size_t i = 0; i < switches.size(); i++)
         {
-            std::shared_ptr<Crime> newCrime = std::make_shared<Crime>(c->id, c);
-            crimes.push_back(newCrime.get());
-            objects[newCrime->id] = newCrime;
+            setSwitch(i, switches[i]->state().aiState == Switch::ON);
         }
+        updateDoors();
+    }
 
-        for(Alarm* a : other.alarms)
+    void setSwitch(int switchIdx, bool on)
+    {
+        if(switchOn[switchIdx] == on)
+        {
+            return;
+        }
+        switchOn[switchIdx] = on;
+        for(int doorIdx : switchDoors[switchIdx])
         {
-            std::shared_ptr<Alarm> newAlarm = std::make_shared<Alarm>(a->id, a);
-            alarms.push_back(newAlarm.get());
-            objects[newAlarm->id] = newAlarm;
+            onCount[doorIdx] += on ? 1 : -1;
+            doorDirty[doorIdx] = true;
         }
+    }
+
+    //A door is open when an odd number of its switches are on
+    void updateDoors()
+    {
+        for(size_t i = 0; i < doors.size(); i++)
+        {
+            if(!doorDirty[i])
+            {
+                continue;
+            }
+            doors[i]->state().aiState = (onCount[i] % 2 == 1) ? Door::OPEN : Door::CLOSED;
+            doors[i]->state().animIdx = doors[i]->state().aiState;
+            doorDirty[i] = false;
+        }
+    }
+
+    std::vector<Switch*> switches;
+    std::vector<ObjectHistory*> histories;
+    //Switch states as last propagated to the doors
+    std::vector<bool> switchOn;
+    //Indices into doors for each switch
+    std::vector<std::vector<int>> switchDoors;
+    std::map<int, int> switchIndex;
+
+    std::vector<Door*> doors;
+    //Number of connected switches that are on, for each door
+    std::vector<int> onCount;
+    std::vector<bool> doorDirty;
+};
+
+//The crimes a new report could belong to, grouped by what makes two reports the same crime, so reporting doesn't
+//go through every crime ever committed. A crime is added when it's reported and removed when it's fully searched.
+//A rewind can make an ended crime active again, so doRewindCleanup and pushTimeline put those back.
+//Each group is kept in report order, which is ID order, and is normally just the one ongoing crime
+class CrimeIndex
+{
+public:
+    void clear()
+    {
+        m_crimes.clear();
+    }
+
+    void add(Crime* crime)
+    {
+        std::vector<Crime*> & group = m_crimes[keyOf(crime)];
+        auto it = std::lower_bound(group.begin(), group.end(), crime, [](Crime* a, Crime* b)
+        {
+            return a->id < b->id;
+        });
+        if(it == group.end() || *it != crime)
+        {
+            group.insert(it, crime);
+        }
+    }
+
+    void remove(Crime* crime)
+    {
+        auto it = m_crimes.find(keyOf(crime));
+        if(it == m_crimes.end())
+        {
+            return;
+        }
+        std::erase(it->second, crime);
+        if(it->second.empty())
+        {
+            m_crimes.erase(it);
+        }
+    }
+
+    //The first reported crime matching the report that is active on the tick, or nullptr if there isn't one.
+    //Crimes that have run past an ending they kept through a rewind are dropped on the way
+    Crime* findActive(int assignedAlarm, Crime::CrimeType crimeType, int subjectId, bool backwards, int tick)
+    {
+        auto it = m_crimes.find(Key{assignedAlarm, crimeType, subjectId, backwards});
+        if(it == m_crimes.end())
+        {
+            return nullptr;
+        }
+        std::erase_if(it->second, [&](Crime* crime)
+        {
+            return !crime->activeAt(tick);
+        });
+        if(it->second.empty())
+        {
+            m_crimes.erase(it);
+            return nullptr;
+        }
+        return it->second.front();
+    }
+
+private:
+    struct Key
+    {
+        int assignedAlarm;
+        int crimeType;
+        int subjectId;
+        bool backwards;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            size_t h = std::hash<int>()(key.assignedAlarm);
+            h = h * 31 + std::hash<int>()(key.crimeType);
+            h = h * 31 + std::hash<int>()(key.subjectId);
+            h = h * 2 + (key.backwards ? 1 : 0);
+            return h;
+        }
+    };
+
+    static Key keyOf(Crime* crime)
+    {
+        return Key{crime->assignedAlarm, crime->crimeType, crime->subjectId, crime->backwards};
+    }
+
+    std::unordered_map<Key, std::vector<Crime*>, KeyHash> m_crimes;
+};
+
+//Bookkeeping for Alarm::crimes and Alarm::enemies.
+//Instead of rebuilding every alarm's lists each tick, the events that change them are queued up
+//and applied at the start of the next tick (see GameState::updateAlarmMembership), so every enemy
+//ticking on the same tick sees the same lists. Anything less predictable, like a rewind or a new
+//timeline, just invalidates the lists so they get rebuilt from scratch.
+struct AlarmMembership
+{
+    AlarmMembership()
+        : dirty(true)
+    {
+    }
+
+    void invalidate()
+    {
+        dirty = true;
+        reportedCrimes.clear();
+        endedCrimes.clear();
+        deadEnemies.clear();
+    }
+
+    void crimeReported(Crime* crime)
+    {
+        reportedCrimes.push_back(crime->id);
+    }
+
+    void crimeEnded(Crime* crime)
+    {
+        endedCrimes.push_back(crime->id);
+    }
+
+    void enemyDied(Enemy* enemy)
+    {
+        deadEnemies.push_back(enemy->id);
+    }
+
+    bool dirty;
+    std::vector<int> reportedCrimes;
+    std::vector<int> endedCrimes;
+    std::vector<int> deadEnemies;
+};
+
+struct Timeline
+{
+    Timeline() {}
+
+    //Objects get their own copies, since the first tick writes to every active one anyway.
+    //The bulky parts, their histories and what recorded players observed, are shared with the parent until they're written to
+    Timeline(const Timeline& other, int breakpoint, bool playerIsBackwards)
+    {
+        //Go through the parent's lists rather than its object map, so every list keeps its order
+        other.lists.forEach([&](const auto & list)
+        {
+            for(GameObject* obj : list)
+            {
+                std::shared_ptr<GameObject> newObj = cloneObject(obj, obj->id);
+                lists.add(newObj.get());
+                objects[newObj->id] = newObj;
+
+                if(Player* newPlayer = objectCast<Player>(newObj.get()))
+                {
+                    newPlayer->shareObservations(static_cast<Player*>(obj));
+                }
+                else if(Crime* newCrime = objectCast<Crime>(newObj.get()))
+                {
+                    if(newCrime->activeAt(breakpoint))
+                    {
+                        crimeIndex.add(newCrime);
+                    }
+                }
+            }
+        });
 
         historyBuffer = HistoryBuffer(other.historyBuffer, breakpoint);
     }
 
     std::map<int, std::shared_ptr<GameObject>> objects;
     HistoryBuffer historyBuffer;
+    ReplayLane replayLane;
+    SimLane simLane;
+    SignalGraph signalGraph;
+    CrimeIndex crimeIndex;
 
-    std::vector<Player*> players;
-    std::vector<Bullet*> bullets;
-    std::vector<Enemy*> enemies;
-    std::vector<Switch*> switches;
-    std::vector<Door*> doors;
-    std::vector<Container*> containers;
-    std::vector<Spikes*> spikes;
-    std::vector<Throwable*> throwables;
-    std::vector<Exit*> exits;
-    std::vector<Crime*> crimes;
-    std::vector<Alarm*> alarms;
+    //Players, bullets, enemies and so on. See ObjectTypes.hh
+    TimelineLists lists;
 };
 
 struct EditorState
@@ -220,32 +746,38 @@ struct EditorState
     bool snapToGrid;
 };
 
-typedef std::vector<std::vector<bool>> VisibilityGrid;
-
 struct GameState {
     int tick;
     std::shared_ptr<Level> level;
     std::vector<Timeline> timelines;
-    std::vector<std::shared_ptr<Promise>> promises;
+    PromiseRegistry promises;
+    AlarmMembership alarmMembership;
 
     int currentTimeline() { return timelines.size() - 1; }
     bool backwards(){ return timelines.size() % 2 == 0; }
 
     std::map<int, std::shared_ptr<GameObject>> & objects() { return timelines.back().objects; }
 
-    std::vector<Player*> & players() { return timelines.back().players; }
-    Player * currentPlayer() { return timelines.back().players.back(); }
-    std::vector<Bullet*> & bullets() { return timelines.back().bullets; }
-    std::vector<Enemy*> & enemies() { return timelines.back().enemies; }
-    std::vector<Switch*> & switches() { return timelines.back().switches; }
-    std::vector<Door*> & doors() { return timelines.back().doors; }
-    std::vector<Container*> & containers() { return timelines.back().containers; }
-    std::vector<Spikes*> & spikes() { return timelines.back().spikes; }
-    std::vector<Throwable*> & throwables() { return timelines.back().throwables; }
-    std::vector<Exit*> & exits() { return timelines.back().exits; }
-    std::vector<Crime*> & crimes() { return timelines.back().crimes; }
-    std::vector<Alarm*> & alarms() { return timelines.back().alarms; }
+    std::vector<Player*> & players() { return timelines.back().lists.get<Player>(); }
+    Player * currentPlayer() { return timelines.back().lists.get<Player>().back(); }
+    std::vector<Bullet*> & bullets() { return timelines.back().lists.get<Bullet>(); }
+    std::vector<Enemy*> & enemies() { return timelines.back().lists.get<Enemy>(); }
+    std::vector<Switch*> & switches() { return timelines.back().lists.get<Switch>(); }
+    std::vector<Door*> & doors() { return timelines.back().lists.get<Door>(); }
+    std::vector<Container*> & containers() { return timelines.back().lists.get<Container>(); }
+    std::vector<Spikes*> & spikes() { return timelines.back().lists.get<Spikes>(); }
+    std::vector<Throwable*> & throwables() { return timelines.back().lists.get<Throwable>(); }
+    std::vector<Exit*> & exits() { return timelines.back().lists.get<Exit>(); }
+    std::vector<Crime*> & crimes() { return timelines.back().lists.get<Crime>(); }
+    std::vector<Alarm*> & alarms() { return timelines.back().lists.get<Alarm>(); }
+    //The same objects as the lists above, with their components
+    template<typename L>
+    ComponentTable<L> & table() { return timelines.back().lists.table<L>(); }
     HistoryBuffer & historyBuffer() { return timelines.back().historyBuffer; }
+    ReplayLane & replayLane() { return timelines.back().replayLane; }
+    SimLane & simLane() { return timelines.back().simLane; }
+    SignalGraph & signalGraph() { return timelines.back().signalGraph; }
+    CrimeIndex & crimeIndex() { return timelines.back().crimeIndex; }
     int m_lastID;
 
     VisibilityGrid obstructionGrid;
@@ -259,6 +791,10 @@ struct GameState {
     bool shouldReverse;
     int boxToEnter;
     std::map<int, VisibilityGrid> visibilityGrids;
+    //Shared by all timelines, since recorded players see the same thing in each of them
+    VisibilityCache visibilityCache;
+    //What enemies can see this tick, see tick::buildThreatMap
+    ThreatMap threatMap;
 
     EditorState editorState;
 
@@ -276,103 +812,184 @@ struct GameState {
     void addObject(std::shared_ptr<GameObject> obj)
     {
         objects()[obj->id] = obj;
-        historyBuffer().buffer[obj->id] = std::vector<ObjectState>(1);
-        historyBuffer().buffer[obj->id][0] = obj->state;
+        if(!obj->isAnalytic())
+        {
+            historyBuffer().buffer[obj->id] = ObjectHistory(1);
+            historyBuffer().buffer[obj->id].set(0, obj->state());
+            simLane().add(obj.get(), &historyBuffer()[obj->id]);
+        }
 
         if(obj->id >= m_lastID)
         {
             m_lastID = obj->id + 1;
         }
 
-        switch(obj->type())
-        {
-            case GameObject::PLAYER:
-                players().push_back(dynamic_cast<Player*>(obj.get()));
-                break;
-            case GameObject::BULLET:
-                bullets().push_back(dynamic_cast<Bullet*>(obj.get()));
-                break;
-            case GameObject::ENEMY:
-                enemies().push_back(dynamic_cast<Enemy*>(obj.get()));
-                break;
-            case GameObject::SWITCH:
-                switches().push_back(dynamic_cast<Switch*>(obj.get()));
-                break;
-            case GameObject::DOOR:
-                doors().push_back(dynamic_cast<Door*>(obj.get()));
-                break;
-            case GameObject::TIMEBOX:
-            case GameObject::CLOSET:
-            case GameObject::TURNSTILE:
-                containers().push_back(dynamic_cast<Container*>(obj.get()));
-                break;
-            case GameObject::SPIKES:
-                spikes().push_back(dynamic_cast<Spikes*>(obj.get()));
-                break;
-            case GameObject::OBJECTIVE:
-            case GameObject::KNIFE:
-            case GameObject::GUN:
-                throwables().push_back(dynamic_cast<Throwable*>(obj.get()));
-                break;
-            case GameObject::EXIT:
-                exits().push_back(dynamic_cast<Exit*>(obj.get()));
-                break;
-            case GameObject::CRIME:
-                crimes().push_back(dynamic_cast<Crime*>(obj.get()));
-                break;
-            case GameObject::ALARM:
-                alarms().push_back(dynamic_cast<Alarm*>(obj.get()));
-                break;
+        timelines.back().lists.add(obj.get());
+        if(objectCast<Container>(obj.get()))
+        {
+            historyBuffer().occupancy[obj->id].set(0, obj->state());
+        }
+        else if(Crime* crime = objectCast<Crime>(obj.get()))
+        {
+            crimeIndex().add(crime);
         }
     }
 
+    //Add an object created during play, with history from this tick.
+    //It's simulated until the timeline's objects are next classified
+    void spawnObject(std::shared_ptr<GameObject> obj)
+    {
+        objects()[obj->id] = obj;
+        timelines.back().lists.add(obj.get());
+        if(Crime* crime = objectCast<Crime>(obj.get()))
+        {
+            crimeIndex().add(crime);
+        }
+
+        historyBuffer().buffer[obj->id] = ObjectHistory(tick+1);
+        historyBuffer().buffer[obj->id].set(tick, obj->state());
+        simLane().add(obj.get(), &historyBuffer()[obj->id]);
+    }
+
     void deleteObject(int id)
     {
         std::cout << "Deleting " << GameObject::typeToString(objects().at(id)->type()) << " with ID " << id << std::endl;
-        switch(objects().at(id)->type())
-        {
-            case GameObject::PLAYER:
-                std::erase_if(players(), [id](Player* p){return p->id == id;});
-                break;
-            case GameObject::BULLET:
-                std::erase_if(bullets(), [id](Bullet* b){return b->id == id;});
-                break;
-            case GameObject::ENEMY:
-                std::erase_if(enemies(), [id](Enemy* e){return e->id == id;});
-                break;
-            case GameObject::SWITCH:
-                std::erase_if(switches(), [id](Switch* s){return s->id == id;});
-                break;
-            case GameObject::DOOR:
-                std::erase_if(doors(), [id](Door* d){return d->id == id;});
-                break;
-            case GameObject::TIMEBOX:
-            case GameObject::CLOSET:
-            case GameObject::TURNSTILE:
-                std::erase_if(containers(), [id](Container* c){return c->id == id;});
-                break;
-            case GameObject::SPIKES:
-                std::erase_if(spikes(), [id](Spikes* s){return s->id == id;});
-                break;
-            case GameObject::OBJECTIVE:
-            case GameObject::KNIFE:
-            case GameObject::GUN:
-                std::erase_if(throwables(), [id](Throwable* t){return t->id == id;});
-                break;
-            case GameObject::EXIT:
-                std::erase_if(exits(), [id](Exit* e){return e->id == id;});
-                break;
-            case GameObject::CRIME:
-                std::erase_if(crimes(), [id](Crime* c){return c->id == id;});
-                break;
-            case GameObject::ALARM:
-                std::erase_if(alarms(), [id](Alarm* a){return a->id == id;});
-                break;
-            default:
-                throw std::runtime_error("Object type " + GameObject::typeToString(objects().at(id)->type()) + " not handled in deleteObject");
-                break;
+        GameObject* obj = objects().at(id).get();
+        if(!timelines.back().lists.remove(obj))
+        {
+            throw std::runtime_error("Object type " + GameObject::typeToString(obj->type()) + " not handled in deleteObject");
         }
+        if(Crime* crime = objectCast<Crime>(obj))
+        {
+            crimeIndex().remove(crime);
+        }
+        else if(objectCast<Player>(obj))
+        {
+            visibilityCache.forgetPlayer(id);
+        }
+        GameObject::ObjectType type = objects().at(id)->type();
+        replayLane().remove(id);
+        simLane().remove(id);
+        //IDs are never reused, so nothing will look at its history again
+        historyBuffer().buffer.erase(id);
+        historyBuffer().occupancy.erase(id);
         objects().erase(id);
+
+        if(type == GameObject::SWITCH || type == GameObject::DOOR)
+        {
+            buildSignalGraph();
+        }
+        if(type == GameObject::CRIME || type == GameObject::ENEMY || type == GameObject::ALARM)
+        {
+            alarmMembership.invalidate();
+        }
+    }
+
+    //Decide which objects are simulated and which are replayed from history in the current timeline
+    //This only changes when timelines are pushed or popped, so it doesn't need to happen every tick
+    void classifyObjects()
+    {
+        replayLane().clear();
+        simLane().clear();
+        for(auto pair : objects())
+        {
+            GameObject* obj = pair.second.get();
+
+            //Containers can be entered by players from either direction, so they always run through tickContainer
+            bool isContainer = objectCast<Container>(obj) != nullptr;
+
+            //Analytic objects have no history to replay, they are evaluated the same way in every timeline
+            obj->replayed = !isContainer && !obj->isAnalytic() && (obj->recorded || obj->backwards != backwards());
+            obj->asleep = false;
+            if(obj->replayed)
+            {
+                replayLane().add(obj, &historyBuffer()[obj->id]);
+            }
+            else if(!obj->isAnalytic())
+            {
+                simLane().add(obj, &historyBuffer()[obj->id]);
+            }
+        }
+    }
+
+    //Compile the switch -> door connections for the current timeline's objects
+    //Like classifyObjects, this only needs redoing when the timeline or the set of switches and doors changes
+    void buildSignalGraph()
+    {
+        signalGraph().clear();
+        for(Switch* sw : switches())
+        {
+            signalGraph().addSwitch(sw, &historyBuffer()[sw->id]);
+        }
+        for(Door* door : doors())
+        {
+            signalGraph().addDoor(door);
+        }
+    }
+
+    //Bring Alarm::crimes and Alarm::enemies up to date for the current tick
+    void updateAlarmMembership()
+    {
+        if(alarmMembership.dirty)
+        {
+            rebuildAlarmMembership();
+            return;
+        }
+
+        for(int crimeId : alarmMembership.reportedCrimes)
+        {
+            Crime * crime = getObject<Crime>(crimeId);
+            getObject<Alarm>(crime->assignedAlarm)->crimes.push_back(crimeId);
+        }
+        for(int crimeId : alarmMembership.endedCrimes)
+        {
+            Crime * crime = getObject<Crime>(crimeId);
+            std::erase(getObject<Alarm>(crime->assignedAlarm)->crimes, crimeId);
+        }
+        for(int enemyId : alarmMembership.deadEnemies)
+        {
+            Enemy * enemy = getObject<Enemy>(enemyId);
+            std::erase(getObject<Alarm>(enemy->assignedAlarm)->enemies, enemyId);
+        }
+        alarmMembership.reportedCrimes.clear();
+        alarmMembership.endedCrimes.clear();
+        alarmMembership.deadEnemies.clear();
+    }
+
+    void rebuildAlarmMembership()
+    {
+        for(Alarm * alarm : alarms())
+        {
+            alarm->crimes.clear();
+            alarm->enemies.clear();
+        }
+        for(Crime * crime : crimes())
+        {
+            if(!crime->activeAt(tick) || crime->backwards != backwards())
+            {
+                continue;
+            }
+            if(crime->assignedAlarm == -1)
+            {
+                throw std::runtime_error("Crime has no assigned alarm!");
+            }
+            getObject<Alarm>(crime->assignedAlarm)->crimes.push_back(crime->id);
+        }
+        for(Enemy * enemy : enemies())
+        {
+            if(!enemy->activeAt(tick) || enemy->backwards != backwards())
+            {
+                continue;
+            }
+            if(enemy->assignedAlarm == -1 || enemy->state().aiState == Enemy::AI_DEAD)
+            {
+                continue;
+            }
+            getObject<Alarm>(enemy->assignedAlarm)->enemies.push_back(enemy->id);
+        }
+
+        alarmMembership.invalidate();
+        alarmMembership.dirty = false;
     }
 
     void restoreState()
@@ -380,7 +997,19 @@ struct GameState {
         for(auto pair : objects())
         {
             std::shared_ptr<GameObject> obj = pair.second;
-            obj->state = historyBuffer()[obj->id][tick];
+            obj->asleep = false;
+
+            if(obj->isAnalytic())
+            {
+                continue;
+            }
+
+            //Objects that have already ended have no history this late, and they aren't active anyway
+            ObjectHistory & history = historyBuffer()[obj->id];
+            if(tick < history.size())
+            {
+                obj->state() = history[tick];
+            }
         }
     }
 
@@ -393,7 +1022,7 @@ struct GameState {
             throw std::runtime_error("No object with ID " + std::to_string(id));
         }
 
-        T* ptr = dynamic_cast<T*>(it->second.get());
+        T* ptr = objectCast<T>(it->second.get());
         if(ptr == nullptr)
         {
             throw std::runtime_error("Object with ID " + std::to_string(id) + " is not of type " + typeid(T).name());
@@ -467,75 +1096,29 @@ struct GameState {
                     }
                 }
             }
-        }
-        for(int id : toDelete)
-        {
-            deleteObject(id);
-        }
 
-        //Remove promises whose origin we've rewound past
-        std::vector<std::shared_ptr<Promise>> toDeletePromises;
-        for(std::shared_ptr<Promise> promise: promises)
-        {
-            if(promise->originTimeline > currentTimeline())
+            //A crime that was fully searched after this tick is being searched again
+            Crime* crime = objectCast<Crime>(obj);
+            if(crime && crime->activeAt(tick))
             {
-                toDeletePromises.push_back(promise);
+                crimeIndex().add(crime);
             }
-            else if(promise->originTimeline == currentTimeline())
-            {
-                if(backwards())
-                {
-                    if(promise->originTick < tick)
-                    {
-                        toDeletePromises.push_back(promise);
-                    }
-                }
-                else
-                {
-                    if(promise->originTick > tick)
-                    {
-                        toDeletePromises.push_back(promise);
-                    }
-                }
-            }
-        }
-        for(std::shared_ptr<Promise> promise: toDeletePromises)
-        {
-            promises.erase(std::remove(promises.begin(), promises.end(), promise), promises.end());
         }
-        //Deactive promises whose activation we've rewound past
-        for(std::shared_ptr<Promise> promise: promises)
+        for(int id : toDelete)
         {
-            if(promise->activatedTimeline > currentTimeline())
-            {
-                promise->activatedTimeline = -1;
-            }
-            else if(promise->activatedTimeline == currentTimeline())
-            {
-                if(backwards())
-                {
-                    if(promise->originTick < tick)
-                    {
-                        promise->activatedTimeline = -1;
-                    }
-                }
-                else
-                {
-                    if(promise->originTick > tick)
-                    {
-                        promise->activatedTimeline = -1;
-                    }
-                }
-            }
+            deleteObject(id);
         }
 
+        //Remove promises whose origin we've rewound past, and deactivate promises whose activation we've rewound past
+        promises.rewind(currentTimeline(), tick, backwards());
+
 
 
         //Special case stuff
         //If the active player is in a box, set the active occupant to the player
-        if(currentPlayer()->state.boxOccupied)
+        if(currentPlayer()->state().boxOccupied)
         {
-            Container* box = dynamic_cast<Container*>(objects().at(currentPlayer()->state.attachedObjectId).get());
+            Container* box = objectCast<Container>(objects().at(currentPlayer()->state().attachedObjectId).get());
             box->activeOccupant = currentPlayer()->id;
         }
     }
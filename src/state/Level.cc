@@ -1,65 +1,99 @@
 #include "Level.hh"
 
+#include <algorithm>
+
 Level::Level(int _width, int _height, const point_t & _bottomLeft, float _scale)
     : bottomLeft(_bottomLeft)
     , scale(_scale)
     , width(_width)
     , height(_height)
 {
-    tiles.resize(width);
-    for (int i = 0; i < width; i++) {
-        tiles[i].resize(height, {WALL, {}});
-    }
+    tiles.resize(width * height, {WALL, 0});
 }
 
 void Level::setupNavMesh() 
 {
     for (int x = 0; x < width; x++) {
         for (int y = 0; y < height; y++) {
-            tiles[x][y].node.pos = point_t((x + 0.5f) * scale + bottomLeft.x, (y + 0.5f) * scale + bottomLeft.y);
-            tiles[x][y].node.x = x;
-            tiles[x][y].node.y = y;
-            tiles[x][y].node.id = y * width + x;
+            updateNavCell(x, y);
+        }
+    }
+}
 
-            if (tiles[x][y].type == WALL) {
-                continue;
-            }
-            tiles[x][y].node.neighbors.clear();
-            bool upEmpty = y < height - 1 && tiles[x][y + 1].type == EMPTY;
-            bool downEmpty = y > 0 && tiles[x][y - 1].type == EMPTY;
-            bool leftEmpty = x > 0 && tiles[x - 1][y].type == EMPTY;
-            bool rightEmpty = x < width - 1 && tiles[x + 1][y].type == EMPTY;
-            //Adjacent
-            if(upEmpty) {
-                tiles[x][y].node.neighbors.push_back(&tiles[x][y + 1].node);
-            }
-            if(downEmpty) {
-                tiles[x][y].node.neighbors.push_back(&tiles[x][y - 1].node);
-            }
-            if(leftEmpty) {
-                tiles[x][y].node.neighbors.push_back(&tiles[x - 1][y].node);
-            }
-            if(rightEmpty) {
-                tiles[x][y].node.neighbors.push_back(&tiles[x + 1][y].node);
-            }
-            //Diagonal
-            if(upEmpty && leftEmpty && tiles[x - 1][y + 1].type == EMPTY) {
-                tiles[x][y].node.neighbors.push_back(&tiles[x - 1][y + 1].node);
-            }
-            if(upEmpty && rightEmpty && tiles[x + 1][y + 1].type == EMPTY) {
-                tiles[x][y].node.neighbors.push_back(&tiles[x + 1][y + 1].node);
-            }
-            if(downEmpty && leftEmpty && tiles[x - 1][y - 1].type == EMPTY) {
-                tiles[x][y].node.neighbors.push_back(&tiles[x - 1][y - 1].node);
-            }
-            if(downEmpty && rightEmpty && tiles[x + 1][y - 1].type == EMPTY) {
-                tiles[x][y].node.neighbors.push_back(&tiles[x + 1][y - 1].node);
-            }
-            
+void Level::updateNavCell(int x, int y)
+{
+    Tile & current = tile(x, y);
+    current.neighbors = 0;
+    if (current.type == WALL) {
+        return;
+    }
+    bool upEmpty = y < height - 1 && tile(x, y + 1).type == EMPTY;
+    bool downEmpty = y > 0 && tile(x, y - 1).type == EMPTY;
+    bool leftEmpty = x > 0 && tile(x - 1, y).type == EMPTY;
+    bool rightEmpty = x < width - 1 && tile(x + 1, y).type == EMPTY;
+    //Adjacent
+    if(upEmpty) {
+        current.neighbors |= 1 << UP;
+    }
+    if(downEmpty) {
+        current.neighbors |= 1 << DOWN;
+    }
+    if(leftEmpty) {
+        current.neighbors |= 1 << LEFT;
+    }
+    if(rightEmpty) {
+        current.neighbors |= 1 << RIGHT;
+    }
+    //Diagonal
+    if(upEmpty && leftEmpty && tile(x - 1, y + 1).type == EMPTY) {
+        current.neighbors |= 1 << UP_LEFT;
+    }
+    if(upEmpty && rightEmpty && tile(x + 1, y + 1).type == EMPTY) {
+        current.neighbors |= 1 << UP_RIGHT;
+    }
+    if(downEmpty && leftEmpty && tile(x - 1, y - 1).type == EMPTY) {
+        current.neighbors |= 1 << DOWN_LEFT;
+    }
+    if(downEmpty && rightEmpty && tile(x + 1, y - 1).type == EMPTY) {
+        current.neighbors |= 1 << DOWN_RIGHT;
+    }
+}
+
+void Level::setTile(int x, int y, TileType type)
+{
+    if (tile(x, y).type == type) {
+        return;
+    }
+    tile(x, y).type = type;
+    for (int nx = std::max(x - 1, 0); nx <= std::min<int>(x + 1, width - 1); nx++) {
+        for (int ny = std::max(y - 1, 0); ny <= std::min<int>(y + 1, height - 1); ny++) {
+            updateNavCell(nx, ny);
         }
     }
 }
 
+void Level::resize(int newWidth, int newHeight)
+{
+    std::vector<Tile> newTiles(newWidth * newHeight, {WALL, 0});
+    for (int x = 0; x < std::min<int>(width, newWidth); x++) {
+        for (int y = 0; y < std::min<int>(height, newHeight); y++) {
+            newTiles[y * newWidth + x] = tile(x, y);
+        }
+    }
+    tiles.swap(newTiles);
+    width = newWidth;
+    height = newHeight;
+
+    //Neighbor bits are directions, so they still hold for the tiles that were kept.
+    //The new tiles are walls, which look the same as the edge did, so only the last row and column can have lost neighbors
+    for (int x = 0; x < width; x++) {
+        updateNavCell(x, height - 1);
+    }
+    for (int y = 0; y < height; y++) {
+        updateNavCell(width - 1, y);
+    }
+}
+
 void Level::setFromLines(const std::vector<std::string> & lines) {
     if (lines.size() != height) {
         throw std::runtime_error("Level does not fit this string");
@@ -70,10 +104,10 @@ void Level::setFromLines(const std::vector<std::string> & lines) {
         }
         for (int x = 0; x < width; x++) {
             if (lines[y][x] == 'X') {
-                tiles[x][height - y - 1].type = WALL;
+                tile(x, height - y - 1).type = WALL;
             }
             else{
-                tiles[x][height - y - 1].type = EMPTY;
+                tile(x, height - y - 1).type = EMPTY;
             }
         }
     }
@@ -94,10 +128,10 @@ void Level::setFromString(const std::string & str) {
             }
             if (c == 'X') {
                 std::cout << "X";
-                tiles[x][height - y - 1].type = WALL;
+                tile(x, height - y - 1).type = WALL;
             }
             else{
-                tiles[x][height - y - 1].type = EMPTY;
+                tile(x, height - y - 1).type = EMPTY;
                 std::cout << " ";
             }
             x++;
@@ -116,17 +150,17 @@ Level::TileType Level::tileAt(const point_t & pos) const
     if (x < 0 || x >= width || y < 0 || y >= height) {
         return WALL;
     }
-    return tiles[x][y].type;
+    return tile(x, y).type;
 }
 
-const Level::NavNode* Level::nodeAt(const point_t & pos) const
+int Level::cellIndexAt(const point_t & pos) const
 {
     int x = (pos.x - bottomLeft.x) / scale;
     int y = (pos.y - bottomLeft.y) / scale;
     if (x < 0 || x >= width || y < 0 || y >= height) {
-        return nullptr;
+        return -1;
     }
-    return &tiles[x][y].node;
+    return cellIndex(x, y);
 }
 
 point_t Level::toLevelCoords(const point_t & worldPos) const
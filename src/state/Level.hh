@@ -1,57 +1,73 @@
 #ifndef __LEVEL_HH__
 #define __LEVEL_HH__
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 #include <queue>
 #include <stdexcept>
 #include <iostream>
 
 #include <utils/MathUtil.hh>
 
+class WallVisibility;
+
 class Level {
 public:
-    enum TileType {
+    enum TileType : uint8_t {
         EMPTY,
         WALL
     };
 
-    struct NavNode {
-        NavNode()
-            : pos(0, 0)
-            , x(0)
-            , y(0)
-            , id(0)
-        {
-        }
-
-        //Position in world space
-        point_t pos;
-        //Position in level grid
-        int x;
-        int y;
-        int id;
-        std::vector<NavNode*> neighbors;
+    //Directions to a cell's neighbors, in the order navigation tries them
+    enum Direction {
+        UP,
+        DOWN,
+        LEFT,
+        RIGHT,
+        UP_LEFT,
+        UP_RIGHT,
+        DOWN_LEFT,
+        DOWN_RIGHT,
+        N_DIRECTIONS
     };
 
+    constexpr static int DIRECTION_DX[N_DIRECTIONS] = {0, 0, -1, 1, -1, 1, -1, 1};
+    constexpr static int DIRECTION_DY[N_DIRECTIONS] = {1, -1, 0, 0, 1, 1, -1, -1};
+
     struct Tile {
         TileType type;
-        NavNode node;
+        //Bit per Direction, set if you can walk straight to that neighbor. Filled in by setupNavMesh
+        uint8_t neighbors;
     };
 
     Level(int _width, int _height, const point_t & _bottomLeft, float _scale);
 
     void setupNavMesh();
 
+    //Work out which neighbors one cell can walk to. Only depends on the 3x3 block of tiles around it
+    void updateNavCell(int x, int y);
+
+    //Change one tile, only redoing the nav mesh for the cells around it
+    void setTile(int x, int y, TileType type);
+
+    //Change the size of the level, keeping the tiles that are still inside it. New tiles are walls
+    void resize(int newWidth, int newHeight);
+
     struct NavMove {
         //Since priority_queue is a max heap, we want to reverse the comparison
         bool operator<(const NavMove & other) const {
             return dist > other.dist;
         }
 
-        NavNode* node;
+        //Index of the cell, see cellIndex
+        int cell;
+        //Cost of the path so far, including any penalties
         float dist;
+        //How far the path actually goes
+        float length;
     };
 
     void setFromLines(const std::vector<std::string> & lines);
@@ -60,7 +76,52 @@ public:
 
     TileType tileAt(const point_t & pos) const;
 
-    const NavNode* nodeAt(const point_t & pos) const;
+    //Index of the cell containing a world position, or -1 if it's outside the level.
+    //Positions less than a cell below or left of the level round into the edge cells, like tileAt
+    int cellIndexAt(const point_t & pos) const;
+
+    //Cells are stored row by row, so a cell's index is also its ID
+    int cellIndex(int x, int y) const
+    {
+        return y * width + x;
+    }
+
+    int cellX(int index) const
+    {
+        return index % width;
+    }
+
+    int cellY(int index) const
+    {
+        return index / width;
+    }
+
+    Tile & tile(int x, int y)
+    {
+        return tiles[cellIndex(x, y)];
+    }
+
+    const Tile & tile(int x, int y) const
+    {
+        return tiles[cellIndex(x, y)];
+    }
+
+    //Center of a cell in world space
+    point_t cellCenter(int x, int y) const
+    {
+        return point_t((x + 0.5f) * scale + bottomLeft.x, (y + 0.5f) * scale + bottomLeft.y);
+    }
+
+    point_t cellCenter(int index) const
+    {
+        return cellCenter(cellX(index), cellY(index));
+    }
+
+    //Index of the neighbor in direction dir. Only meaningful if that neighbor's bit is set
+    int neighborIndex(int index, int dir) const
+    {
+        return index + DIRECTION_DY[dir] * (int)width + DIRECTION_DX[dir];
+    }
 
     point_t toLevelCoords(const point_t & worldPos) const;
     point_t fromLevelCoords(const point_t & levelPos) const;
@@ -73,8 +134,12 @@ public:
     size_t height;
     float scale;
 
-    std::vector<std::vector<Tile>> tiles;
-    
+    //Row by row, see cellIndex
+    std::vector<Tile> tiles;
+
+    //Only set while the level is being played, since the editor can move walls
+    std::shared_ptr<const WallVisibility> wallVisibility;
+
 };
 
 #endif
\ No newline at end of file
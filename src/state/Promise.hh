@@ -1,6 +1,12 @@
 #ifndef __PROMISE_HH__
 #define __PROMISE_HH__
 
+#include <iterator>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 class Promise
 {
 
@@ -32,4 +38,124 @@ public:
     PromiseType type;
 };
 
+//All promises, indexed by target so objects can look up their own promises, and by origin tick so
+//pending promises are activated when time reaches them instead of every promise being checked every tick
+class PromiseRegistry
+{
+public:
+    void add(std::shared_ptr<Promise> promise)
+    {
+        m_promises.push_back(promise);
+        m_byTarget[promise->target].push_back(promise.get());
+        m_pending.insert({promise->originTick, promise.get()});
+    }
+
+    //Does the target have a promise of this type that hasn't been activated yet?
+    bool hasPending(int target, Promise::PromiseType type)
+    {
+        auto it = m_byTarget.find(target);
+        if(it == m_byTarget.end())
+        {
+            return false;
+        }
+        for(Promise* promise : it->second)
+        {
+            if(promise->type == type && promise->activatedTimeline < 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //Activate pending promises whose origin is later than the tick, returning the ones that were activated
+    std::vector<Promise*> activate(int timeline, int tick)
+    {
+        std::vector<Promise*> activated;
+        while(!m_pending.empty() && std::prev(m_pending.end())->first > tick)
+        {
+            auto it = std::prev(m_pending.end());
+            Promise* promise = it->second;
+            m_pending.erase(it);
+
+            promise->activatedTimeline = timeline;
+            m_activated.push_back(promise);
+            activated.push_back(promise);
+        }
+        return activated;
+    }
+
+    //Remove promises whose origin has been rewound past, and deactivate ones whose activation has been
+    //Promises are only made or activated in the latest timeline, and anything from a later timeline is cleared
+    //out here when it's popped, so only the back of each list can be affected
+    void rewind(int timeline, int tick, bool backwards)
+    {
+        std::vector<Promise*> toDelete;
+        for(int i = m_promises.size() - 1; i >= 0 && m_promises[i]->originTimeline >= timeline; i--)
+        {
+            Promise* promise = m_promises[i].get();
+            if(promise->originTimeline > timeline
+                || (backwards && promise->originTick < tick)
+                || (!backwards && promise->originTick > tick))
+            {
+                toDelete.push_back(promise);
+            }
+        }
+        for(Promise* promise : toDelete)
+        {
+            remove(promise);
+        }
+
+        std::vector<Promise*> toDeactivate;
+        for(int i = m_activated.size() - 1; i >= 0 && m_activated[i]->activatedTimeline >= timeline; i--)
+        {
+            Promise* promise = m_activated[i];
+            if(promise->activatedTimeline > timeline
+                || (backwards && promise->originTick < tick)
+                || (!backwards && promise->originTick > tick))
+            {
+                toDeactivate.push_back(promise);
+            }
+        }
+        for(Promise* promise : toDeactivate)
+        {
+            promise->activatedTimeline = -1;
+            std::erase(m_activated, promise);
+            m_pending.insert({promise->originTick, promise});
+        }
+    }
+
+    const std::vector<std::shared_ptr<Promise>>& all() const
+    {
+        return m_promises;
+    }
+
+private:
+    void remove(Promise* promise)
+    {
+        std::erase(m_byTarget[promise->target], promise);
+        std::erase(m_activated, promise);
+
+        auto range = m_pending.equal_range(promise->originTick);
+        for(auto it = range.first; it != range.second; it++)
+        {
+            if(it->second == promise)
+            {
+                m_pending.erase(it);
+                break;
+            }
+        }
+
+        //Last, since this owns the promise
+        std::erase_if(m_promises, [promise](const std::shared_ptr<Promise>& p){ return p.get() == promise; });
+    }
+
+    std::vector<std::shared_ptr<Promise>> m_promises;
+    std::unordered_map<int, std::vector<Promise*>> m_byTarget;
+    //Promises that haven't been activated, keyed by origin tick
+    std::multimap<int, Promise*> m_pending;
+    //Activated promises in the order they were activated
+    std::vector<Promise*> m_activated;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#ifndef __THREAT_MAP_HH__
+#define __THREAT_MAP_HH__
+
+#include "VisibilityCache.hh"
+#include <utils/MathBatch.hh>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//Which level cells each enemy can see on the current tick.
+//A cell counts as seen if the point at its center is visible to the enemy, so looking a cell up here
+//gives the same answer as checking that point directly. Cells are only worked out the first time they're asked about
+//(see tick::enemySeesCell), then every later question about them that tick is a lookup.
+class ThreatMap
+{
+public:
+    enum CellState : uint8_t
+    {
+        UNKNOWN = 0,
+        UNSEEN,
+        SEEN
+    };
+
+    //The cells around one enemy, in a square that covers its whole view radius
+    struct Raster
+    {
+        Raster()
+            : originX(0)
+            , originY(0)
+            , size(0)
+        {
+        }
+
+        bool started() const
+        {
+            return !cells.empty();
+        }
+
+        void start(int _originX, int _originY, int _size)
+        {
+            originX = _originX;
+            originY = _originY;
+            size = _size;
+            cells.assign(_size * _size, UNKNOWN);
+        }
+
+        bool inside(int x, int y) const
+        {
+            return x >= originX && x < originX + size && y >= originY && y < originY + size;
+        }
+
+        CellState & at(int x, int y)
+        {
+            return cells[(x - originX) * size + (y - originY)];
+        }
+
+        //Lower corner of the square in level coordinates
+        int originX;
+        int originY;
+        int size;
+        std::vector<CellState> cells;
+        //Whether each player is in the enemy's view cone, in the same order as GameState::players(). See tick::playerInView
+        std::vector<math_util::BatchResult> playersInView;
+    };
+
+    //Forget everything from the last tick and make room for these enemies.
+    //Each enemy's raster is only written by whoever is ticking that enemy, so they can be filled in parallel
+    void reset(const std::vector<int> & enemyIds)
+    {
+        m_slots.clear();
+        m_rasters.assign(enemyIds.size(), Raster());
+        for(size_t i = 0; i < enemyIds.size(); i++)
+        {
+            m_slots[enemyIds[i]] = i;
+        }
+        m_combined.clear();
+    }
+
+    Raster & raster(int enemyId)
+    {
+        auto it = m_slots.find(enemyId);
+        if(it == m_slots.end())
+        {
+            throw std::runtime_error("ThreatMap: No raster for enemy " + std::to_string(enemyId));
+        }
+        return m_rasters[it->second];
+    }
+
+    //Cells seen by at least one enemy. Only filled in by tick::buildThreatMap, for the debug overlay
+    VisibilityGrid & combined()
+    {
+        return m_combined;
+    }
+
+    const VisibilityGrid & combined() const
+    {
+        return m_combined;
+    }
+
+private:
+    std::unordered_map<int, int> m_slots;
+    std::vector<Raster> m_rasters;
+    VisibilityGrid m_combined;
+};
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef __VISIBILITY_CACHE_HH__
+#define __VISIBILITY_CACHE_HH__
+
+#include <objects/GameObject.hh>
+
+#include <climits>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::vector<bool>> VisibilityGrid;
+
+//Players' visibility grids by tick, so they aren't raycast again every time a tick comes around.
+//Recorded players always have the same state on the same tick, and rewinds and new timelines go back over
+//the same ticks, so most lookups hit. Each entry remembers everything its grid was computed from and
+//only counts as a hit if all of it matches, so a cached grid is always the one that would have been computed.
+//Grids are stored as run lengths, since they're mostly long runs of the same value.
+//The least recently used grids and obstruction layouts are dropped once there are too many of them.
+class VisibilityCache
+{
+public:
+    constexpr static size_t MAX_ENTRIES = 32768;
+    constexpr static size_t MAX_LAYERS = 64;
+
+    VisibilityCache()
+        : m_nextLayer(0)
+        , m_layerClock(0)
+    {
+    }
+
+    //Everything a player's visibility grid depends on
+    struct Key
+    {
+        Key()
+            : pos(0, 0)
+            , angle_deg(0)
+            , boxOccupied(false)
+            , obstructionLayer(-1)
+        {
+        }
+
+        Key(const ObjectState & playerState, int _obstructionLayer)
+            : pos(playerState.pos)
+            , angle_deg(playerState.angle_deg)
+            , boxOccupied(playerState.boxOccupied)
+            , obstructionLayer(_obstructionLayer)
+        {
+        }
+
+        bool operator==(const Key& other) const = default;
+
+        point_t pos;
+        float angle_deg;
+        bool boxOccupied;
+        int obstructionLayer;
+    };
+
+    //ID for the layout of an obstruction grid. The same layout gets the same ID for as long as it's kept,
+    //so grids can be reused when doors go back to how they were. IDs of dropped layouts are never given out again
+    int obstructionLayer(const VisibilityGrid & obstructionGrid)
+    {
+        m_layerClock++;
+        uint64_t hash = 14695981039346656037ull;
+        for(const std::vector<bool> & column : obstructionGrid)
+        {
+            for(bool obstructed : column)
+            {
+                hash = (hash ^ (obstructed ? 1 : 0)) * 1099511628211ull;
+            }
+        }
+
+        auto range = m_layersByHash.equal_range(hash);
+        for(auto it = range.first; it != range.second; it++)
+        {
+            Layer & layer = m_layers.at(it->second);
+            if(layer.grid == obstructionGrid)
+            {
+                layer.lastUsed = m_layerClock;
+                return it->second;
+            }
+        }
+
+        if(m_layers.size() >= MAX_LAYERS)
+        {
+            dropOldestLayer();
+        }
+        int id = m_nextLayer++;
+        m_layers[id] = Layer{obstructionGrid, hash, m_layerClock};
+        m_layersByHash.insert({hash, id});
+        return id;
+    }
+
+    //Fill in grid and return true if there's a grid for this player and tick computed from the same key
+    //Doesn't modify the cache, so it's safe to call from several threads at once
+    bool find(int playerId, int tick, const Key & key, VisibilityGrid & grid) const
+    {
+        auto it = m_entries.find({playerId, tick});
+        if(it == m_entries.end() || !(it->second.key == key))
+        {
+            return false;
+        }
+        decode(it->second, grid);
+        return true;
+    }
+
+    void store(int playerId, int tick, const Key & key, const VisibilityGrid & grid)
+    {
+        auto inserted = m_entries.try_emplace({playerId, tick});
+        Entry & entry = inserted.first->second;
+        if(inserted.second)
+        {
+            m_recency.push_front(inserted.first->first);
+            entry.recency = m_recency.begin();
+        }
+        else
+        {
+            touch(entry);
+        }
+        entry.key = key;
+        encode(grid, entry);
+
+        if(m_entries.size() > MAX_ENTRIES)
+        {
+            m_entries.erase(m_recency.back());
+            m_recency.pop_back();
+        }
+    }
+
+    //Mark a grid that find just returned as recently used. Unlike find, this isn't safe to call from several threads
+    void touch(int playerId, int tick)
+    {
+        auto it = m_entries.find({playerId, tick});
+        if(it != m_entries.end())
+        {
+            touch(it->second);
+        }
+    }
+
+    //Drop every grid for a player that's gone for good, like one from a popped timeline
+    void forgetPlayer(int playerId)
+    {
+        auto first = m_entries.lower_bound({playerId, INT_MIN});
+        auto last = m_entries.upper_bound({playerId, INT_MAX});
+        for(auto it = first; it != last; it++)
+        {
+            m_recency.erase(it->second.recency);
+        }
+        m_entries.erase(first, last);
+    }
+
+private:
+    struct Entry
+    {
+        Key key;
+        int width;
+        int height;
+        //Lengths of alternating runs of invisible and visible cells, going down each column in turn.
+        //The first run is invisible and may be empty. Runs too long for a uint16_t are split with empty runs in between
+        std::vector<uint16_t> runs;
+        //Position in m_recency
+        std::list<std::pair<int, int>>::iterator recency;
+    };
+
+    struct Layer
+    {
+        VisibilityGrid grid;
+        uint64_t hash;
+        uint64_t lastUsed;
+    };
+
+    void touch(Entry & entry)
+    {
+        m_recency.splice(m_recency.begin(), m_recency, entry.recency);
+    }
+
+    //Grids that were computed with the dropped layer can't be hit any more, so they'll age out on their own
+    void dropOldestLayer()
+    {
+        auto oldest = m_layers.begin();
+        for(auto it = m_layers.begin(); it != m_layers.end(); it++)
+        {
+            if(it->second.lastUsed < oldest->second.lastUsed)
+            {
+                oldest = it;
+            }
+        }
+        auto range = m_layersByHash.equal_range(oldest->second.hash);
+        for(auto it = range.first; it != range.second; it++)
+        {
+            if(it->second == oldest->first)
+            {
+                m_layersByHash.erase(it);
+                break;
+            }
+        }
+        m_layers.erase(oldest);
+    }
+
+    static void encode(const VisibilityGrid & grid, Entry & entry)
+    {
+        entry.width = grid.size();
+        entry.height = grid.empty() ? 0 : grid[0].size();
+        entry.runs.clear();
+
+        bool current = false;
+        uint32_t length = 0;
+        for(const std::vector<bool> & column : grid)
+        {
+            for(bool visible : column)
+            {
+                if(visible != current || length == UINT16_MAX)
+                {
+                    entry.runs.push_back(length);
+                    if(visible == current)
+                    {
+                        //Split an overlong run
+                        entry.runs.push_back(0);
+                    }
+                    current = visible;
+                    length = 0;
+                }
+                length++;
+            }
+        }
+        entry.runs.push_back(length);
+    }
+
+    static void decode(const Entry & entry, VisibilityGrid & grid)
+    {
+        grid.assign(entry.width, std::vector<bool>(entry.height, false));
+
+        int cell = 0;
+        bool visible = false;
+        for(uint16_t length : entry.runs)
+        {
+            if(visible)
+            {
+                for(int i = cell; i < cell + length; i++)
+                {
+                    grid[i / entry.height][i % entry.height] = true;
+                }
+            }
+            cell += length;
+            visible = !visible;
+        }
+    }
+
+    //Keyed by player ID and tick
+    std::map<std::pair<int, int>, Entry> m_entries;
+    //Keys of m_entries, most recently used first
+    std::list<std::pair<int, int>> m_recency;
+
+    std::unordered_map<int, Layer> m_layers;
+    std::unordered_multimap<uint64_t, int> m_layersByHash;
+    int m_nextLayer;
+    uint64_t m_layerClock;
+};
+
+#endif
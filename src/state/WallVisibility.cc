@@ -0,0 +1,296 @@
+#include "WallVisibility.hh"
+
+#include <utils/JobSystem.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+//How far lines are kept from walls in world units, to allow for rounding as checkVisibility steps along them
+static const float WALL_MARGIN = 1.0f;
+
+static const char FILE_MAGIC[4] = {'P', 'V', 'S', '1'};
+
+//Does the segment from (x0, y0) to (x1, y1) touch the box, edges included?
+static bool segmentTouchesBox(double x0, double y0, double x1, double y1, double minX, double minY, double maxX, double maxY)
+{
+    double start[2] = {x0, y0};
+    double delta[2] = {x1 - x0, y1 - y0};
+    double low[2] = {minX, minY};
+    double high[2] = {maxX, maxY};
+
+    double tMin = 0;
+    double tMax = 1;
+    for(int axis = 0; axis < 2; axis++)
+    {
+        if(delta[axis] == 0)
+        {
+            if(start[axis] < low[axis] || start[axis] > high[axis])
+            {
+                return false;
+            }
+            continue;
+        }
+        double t1 = (low[axis] - start[axis]) / delta[axis];
+        double t2 = (high[axis] - start[axis]) / delta[axis];
+        if(t1 > t2)
+        {
+            std::swap(t1, t2);
+        }
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if(tMin > tMax)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+WallVisibility::WallVisibility(const Level & level, float maxDistance)
+    : m_bottomLeft(level.bottomLeft)
+    , m_spotSize(level.scale / SUBDIVISIONS)
+    , m_width(level.width * SUBDIVISIONS)
+    , m_height(level.height * SUBDIVISIONS)
+    , m_radius(std::ceil(maxDistance / m_spotSize) + 1)
+    , m_spots(m_width * m_height, Spot{0, 0, 0, 0, 0})
+{
+    for(int x = 0; x < level.width; x++)
+    {
+        for(int y = 0; y < level.height; y++)
+        {
+            m_layout.push_back(level.tile(x, y).type);
+        }
+    }
+}
+
+std::shared_ptr<WallVisibility> WallVisibility::loadOrBuild(const Level & level, float maxDistance, const std::string & path)
+{
+    std::shared_ptr<WallVisibility> table(new WallVisibility(level, maxDistance));
+    if(table->load(path))
+    {
+        return table;
+    }
+
+    table->build(level);
+    table->save(path);
+    return table;
+}
+
+void WallVisibility::build(const Level & level)
+{
+    //Everything below is in spots, with spot (x, y) covering [x, x + 1) x [y, y + 1)
+    //Lines between any points in two spots stay within half a spot of the line between their centers,
+    //so the pair is clear if that line stays more than half a spot plus the margin outside every wall tile
+    double margin = 0.5 + WALL_MARGIN / m_spotSize;
+    auto isWall = [&level](int tileX, int tileY)
+    {
+        //Out of bounds counts as a wall, since checkVisibility stops there too
+        return tileX < 0 || tileX >= level.width || tileY < 0 || tileY >= level.height || level.tile(tileX, tileY).type == Level::WALL;
+    };
+
+    //Each column of spots is worked out separately, then they're put together in order
+    int diameter = 2 * m_radius + 1;
+    std::vector<std::vector<uint64_t>> columnBits(m_width);
+    JobSystem::get().parallelFor(m_width, 1, [&](int ax)
+    {
+        std::vector<char> visible(diameter * diameter);
+        for(int ay = 0; ay < m_height; ay++)
+        {
+            Spot & spot = m_spots[ax * m_height + ay];
+            if(isWall(ax / SUBDIVISIONS, ay / SUBDIVISIONS))
+            {
+                continue;
+            }
+            double centerAX = ax + 0.5;
+            double centerAY = ay + 0.5;
+
+            int minDX = diameter;
+            int minDY = diameter;
+            int maxDX = -1;
+            int maxDY = -1;
+            std::fill(visible.begin(), visible.end(), 0);
+            for(int bx = std::max(ax - m_radius, 0); bx <= std::min(ax + m_radius, m_width - 1); bx++)
+            {
+                for(int by = std::max(ay - m_radius, 0); by <= std::min(ay + m_radius, m_height - 1); by++)
+                {
+                    double centerBX = bx + 0.5;
+                    double centerBY = by + 0.5;
+
+                    //Go along the line a column of tiles at a time, only looking at the tiles it comes near in each column
+                    int minTileX = std::floor((std::min(centerAX, centerBX) - margin) / SUBDIVISIONS);
+                    int maxTileX = std::floor((std::max(centerAX, centerBX) + margin) / SUBDIVISIONS);
+                    bool clear = true;
+                    for(int tileX = minTileX; clear && tileX <= maxTileX; tileX++)
+                    {
+                        //Where the line is while it's within the margin of this column
+                        double x0 = std::max(std::min(centerAX, centerBX), tileX * SUBDIVISIONS - margin);
+                        double x1 = std::min(std::max(centerAX, centerBX), (tileX + 1) * SUBDIVISIONS + margin);
+                        double y0 = std::min(centerAY, centerBY);
+                        double y1 = std::max(centerAY, centerBY);
+                        if(centerAX != centerBX)
+                        {
+                            double slope = (centerBY - centerAY) / (centerBX - centerAX);
+                            double atX0 = centerAY + (x0 - centerAX) * slope;
+                            double atX1 = centerAY + (x1 - centerAX) * slope;
+                            y0 = std::min(atX0, atX1);
+                            y1 = std::max(atX0, atX1);
+                        }
+
+                        int minTileY = std::floor((y0 - margin) / SUBDIVISIONS);
+                        int maxTileY = std::floor((y1 + margin) / SUBDIVISIONS);
+                        for(int tileY = minTileY; clear && tileY <= maxTileY; tileY++)
+                        {
+                            //checkVisibility stops as soon as it reaches the destination's tile, even if it's a wall
+                            bool destTile = tileX == bx / SUBDIVISIONS && tileY == by / SUBDIVISIONS;
+                            if(!destTile && isWall(tileX, tileY) && segmentTouchesBox(centerAX, centerAY, centerBX, centerBY,
+                                tileX * SUBDIVISIONS - margin, tileY * SUBDIVISIONS - margin,
+                                (tileX + 1) * SUBDIVISIONS + margin, (tileY + 1) * SUBDIVISIONS + margin))
+                            {
+                                clear = false;
+                            }
+                        }
+                    }
+
+                    if(clear)
+                    {
+                        int dx = bx - ax + m_radius;
+                        int dy = by - ay + m_radius;
+                        visible[dx * diameter + dy] = 1;
+                        minDX = std::min(minDX, dx);
+                        minDY = std::min(minDY, dy);
+                        maxDX = std::max(maxDX, dx);
+                        maxDY = std::max(maxDY, dy);
+                    }
+                }
+            }
+
+            if(maxDX < 0)
+            {
+                continue;
+            }
+            std::vector<uint64_t> & bits = columnBits[ax];
+            spot.firstWord = bits.size();
+            spot.minDX = minDX - m_radius;
+            spot.minDY = minDY - m_radius;
+            spot.sizeX = maxDX - minDX + 1;
+            spot.sizeY = maxDY - minDY + 1;
+            bits.resize(bits.size() + (spot.sizeX * spot.sizeY + 63) / 64, 0);
+            for(int dx = minDX; dx <= maxDX; dx++)
+            {
+                for(int dy = minDY; dy <= maxDY; dy++)
+                {
+                    if(visible[dx * diameter + dy])
+                    {
+                        int bit = (dx - minDX) * spot.sizeY + (dy - minDY);
+                        bits[spot.firstWord + bit / 64] |= uint64_t(1) << (bit % 64);
+                    }
+                }
+            }
+        }
+    });
+
+    m_bits.clear();
+    for(int ax = 0; ax < m_width; ax++)
+    {
+        int columnStart = m_bits.size();
+        for(int ay = 0; ay < m_height; ay++)
+        {
+            m_spots[ax * m_height + ay].firstWord += columnStart;
+        }
+        m_bits.insert(m_bits.end(), columnBits[ax].begin(), columnBits[ax].end());
+    }
+}
+
+bool WallVisibility::load(const std::string & path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    char magic[4];
+    int32_t subdivisions, width, height, radius;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&subdivisions), sizeof(subdivisions));
+    file.read(reinterpret_cast<char*>(&width), sizeof(width));
+    file.read(reinterpret_cast<char*>(&height), sizeof(height));
+    file.read(reinterpret_cast<char*>(&radius), sizeof(radius));
+    if(!file || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 || subdivisions != SUBDIVISIONS || width != m_width || height != m_height || radius != m_radius)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> layout(m_layout.size());
+    file.read(reinterpret_cast<char*>(layout.data()), layout.size());
+    if(!file || layout != m_layout)
+    {
+        std::cout << "Walls have changed since " << path << " was saved" << std::endl;
+        return false;
+    }
+
+    std::vector<Spot> spots(m_spots.size());
+    uint64_t words;
+    file.read(reinterpret_cast<char*>(spots.data()), spots.size() * sizeof(Spot));
+    file.read(reinterpret_cast<char*>(&words), sizeof(words));
+    if(!file)
+    {
+        return false;
+    }
+    //A damaged count could ask for far more memory than the file actually holds
+    std::streampos bitsStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff remaining = file.tellg() - bitsStart;
+    file.seekg(bitsStart);
+    if(!file || words > (uint64_t)remaining / sizeof(uint64_t))
+    {
+        return false;
+    }
+    std::vector<uint64_t> bits(words);
+    file.read(reinterpret_cast<char*>(bits.data()), bits.size() * sizeof(uint64_t));
+    if(!file)
+    {
+        return false;
+    }
+
+    //Don't trust a damaged file to stay inside the bits
+    for(const Spot & spot : spots)
+    {
+        if(spot.sizeX < 0 || spot.sizeY < 0 || spot.firstWord < 0 || spot.firstWord + (spot.sizeX * spot.sizeY + 63) / 64 > (int64_t)bits.size())
+        {
+            return false;
+        }
+    }
+
+    m_spots = spots;
+    m_bits = bits;
+    return true;
+}
+
+void WallVisibility::save(const std::string & path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if(!file.is_open())
+    {
+        //Not a problem, it'll just be built again next time
+        std::cout << "Could not save wall visibility to " << path << std::endl;
+        return;
+    }
+
+    int32_t subdivisions = SUBDIVISIONS;
+    int32_t width = m_width;
+    int32_t height = m_height;
+    int32_t radius = m_radius;
+    uint64_t words = m_bits.size();
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&subdivisions), sizeof(subdivisions));
+    file.write(reinterpret_cast<const char*>(&width), sizeof(width));
+    file.write(reinterpret_cast<const char*>(&height), sizeof(height));
+    file.write(reinterpret_cast<const char*>(&radius), sizeof(radius));
+    file.write(reinterpret_cast<const char*>(m_layout.data()), m_layout.size());
+    file.write(reinterpret_cast<const char*>(m_spots.data()), m_spots.size() * sizeof(Spot));
+    file.write(reinterpret_cast<const char*>(&words), sizeof(words));
+    file.write(reinterpret_cast<const char*>(m_bits.data()), m_bits.size() * sizeof(uint64_t));
+}
@@ -0,0 +1,85 @@
+#ifndef __WALL_VISIBILITY_HH__
+#define __WALL_VISIBILITY_HH__
+
+#include "Level.hh"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//Which pairs of nearby spots can see each other past the level's walls, worked out once per level.
+//The level is split into SUBDIVISIONS x SUBDIVISIONS spots per tile. A pair is only marked clear if every line from
+//anywhere in one spot to anywhere in the other keeps away from every wall (with some margin for rounding),
+//so search::checkVisibility doesn't need to look at tiles for it. The destination's own tile doesn't count,
+//since checkVisibility stops as soon as it gets there.
+//Walls never change during play, but doors do, so those are still checked separately.
+class WallVisibility
+{
+public:
+    //Spots per tile on each axis. Lines between points in two spots can stray half a spot from the line
+    //between their centers, so smaller spots leave fewer pairs that can't be decided from the table
+    constexpr static int SUBDIVISIONS = 2;
+
+    //Read the table from path, or build it and save it there if the file is missing or was built for different walls.
+    //Points further apart than maxDistance on either axis aren't in the table
+    static std::shared_ptr<WallVisibility> loadOrBuild(const Level & level, float maxDistance, const std::string & path);
+
+    //True if nothing but doors can come between any point in one spot and any point in the other
+    bool clear(const point_t & from, const point_t & to) const
+    {
+        int fromX = std::floor((from.x - m_bottomLeft.x) / m_spotSize);
+        int fromY = std::floor((from.y - m_bottomLeft.y) / m_spotSize);
+        if(fromX < 0 || fromX >= m_width || fromY < 0 || fromY >= m_height)
+        {
+            return false;
+        }
+        const Spot & spot = m_spots[fromX * m_height + fromY];
+
+        int dx = (int)std::floor((to.x - m_bottomLeft.x) / m_spotSize) - fromX - spot.minDX;
+        int dy = (int)std::floor((to.y - m_bottomLeft.y) / m_spotSize) - fromY - spot.minDY;
+        if(dx < 0 || dx >= spot.sizeX || dy < 0 || dy >= spot.sizeY)
+        {
+            return false;
+        }
+        int bit = dx * spot.sizeY + dy;
+        return m_bits[spot.firstWord + bit / 64] & (uint64_t(1) << (bit % 64));
+    }
+
+private:
+    //Each spot only keeps bits for the smallest box around it that holds all the spots it can see.
+    //That's usually just the room or corridor it's in, so it's much smaller than the full square
+    struct Spot
+    {
+        int32_t firstWord;
+        //Offset of the box's lower corner from the spot
+        int16_t minDX;
+        int16_t minDY;
+        //Zero for spots that can't see anything, like the ones in walls
+        int16_t sizeX;
+        int16_t sizeY;
+    };
+
+    //Nothing is clear until the table is built or loaded
+    WallVisibility(const Level & level, float maxDistance);
+
+    void build(const Level & level);
+    bool load(const std::string & path);
+    void save(const std::string & path) const;
+
+    //Tile types in column order, to tell whether a saved table was built for these walls
+    std::vector<uint8_t> m_layout;
+    point_t m_bottomLeft;
+    float m_spotSize;
+    //Size of the level in spots
+    int m_width;
+    int m_height;
+    //How many spots away the table goes on each axis
+    int m_radius;
+    std::vector<Spot> m_spots;
+    //Each spot's box of bits, column by column
+    std::vector<uint64_t> m_bits;
+};
+
+#endif
@@ -2,22 +2,16 @@
 
 namespace tick{
 
-void tickBullet(GameState * state, Bullet* bullet)
+void tickBullet(GameState * state, Bullet* bullet, StateBuffer& states, const BulletMotion& motion)
 {
     if(!bullet->activeAt(state->tick))
     {
         return;
     }
 
-    if(bullet->backwards != state->backwards())
-    {
-        bullet->nextState = state->historyBuffer()[bullet->id][state->tick];
-        return;
-    }
-
-    bullet->nextState.pos += bullet->velocity;
+    states.next().pos += motion.velocity;
 
-    if(state->level->tileAt(bullet->state.pos) == Level::WALL)
+    if(state->level->tileAt(states.current().pos) == Level::WALL)
     {
         bullet->finalTimeline = state->currentTimeline();
         bullet->hasFinalTimeline = true;
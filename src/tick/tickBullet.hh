@@ -6,7 +6,8 @@
 
 namespace tick{
 
-void tickBullet(GameState * state, Bullet* bullet);
+//states and motion are the bullet's row in the bullet table
+void tickBullet(GameState * state, Bullet* bullet, StateBuffer& states, const BulletMotion& motion);
 
 
 }
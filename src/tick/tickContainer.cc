@@ -6,71 +6,53 @@ void tickContainer(GameState * state, Container* container)
 {
     if(container->activeOccupant > -1)
     {
-        container->nextState.boxOccupied = true;
-        container->nextState.attachedObjectId = container->activeOccupant;
+        container->nextState().boxOccupied = true;
+        container->nextState().attachedObjectId = container->activeOccupant;
 
         //If about to run into a point where someone else was in the box, kick the current occupant out
-        for(int i=1; i<Container::OCCUPANCY_SPACING + 300; i++)
+        ContainerOccupancy & occupancy = state->historyBuffer().occupancy.at(container->id);
+        int i = occupancy.ticksUntilOtherOccupant(state->tick, container->activeOccupant, state->backwards(), Container::OCCUPANCY_SPACING + 300);
+        if(i > 0)
         {
-            int timestepToCheck;
-            if(state->backwards())
+            if(i<Container::OCCUPANCY_SPACING)
             {
-                timestepToCheck = state->tick - i;
-            }
-            else
-            {
-                timestepToCheck = state->tick + i;
-            }
-
-            if(timestepToCheck < 0 || timestepToCheck >= state->historyBuffer()[container->id].size())
-            {
-                break;
-            }
-
-            ObjectState & objState = state->historyBuffer()[container->id][timestepToCheck];
-            if(objState.boxOccupied && objState.attachedObjectId != container->activeOccupant)
-            {
-                if(i<Container::OCCUPANCY_SPACING)
+                if(container->reverseOnExit)
+                {
+                    state->shouldReverse = true;
+                }
+                else
                 {
-                    if(container->reverseOnExit)
+                    GameObject* occupant = state->objects().at(container->activeOccupant).get();
+                    if(occupant->state().holdingObject)
                     {
-                        state->shouldReverse = true;
+                        Throwable* throwable = objectCast<Throwable>(state->objects().at(occupant->state().heldObjectId).get());
+                        throwable->nextState().visible = true;
                     }
-                    else
-                    {
-                        GameObject* occupant = state->objects().at(container->activeOccupant).get();
-                        if(occupant->state.holdingObject)
-                        {
-                            Throwable* throwable = dynamic_cast<Throwable*>(state->objects().at(occupant->state.heldObjectId).get());
-                            throwable->nextState.visible = true;
-                        }
 
-                        occupant->nextState.boxOccupied = false;
-                        occupant->nextState.attachedObjectId = -1;
-                        occupant->nextState.visible = true;
-                        container->activeOccupant = -1;
+                    occupant->nextState().boxOccupied = false;
+                    occupant->nextState().attachedObjectId = -1;
+                    occupant->nextState().visible = true;
+                    container->activeOccupant = -1;
 
-                        container->nextState.boxOccupied = false;
-                        container->nextState.attachedObjectId = -1;
-                    }
-                }
-                else
-                {
-                    int secondsLeft = (i - Container::OCCUPANCY_SPACING) / 60;
-                    state->statusString = "AUTO-EJECT IN " + std::to_string(secondsLeft);
+                    container->nextState().boxOccupied = false;
+                    container->nextState().attachedObjectId = -1;
                 }
-                break;
+            }
+            else
+            {
+                int secondsLeft = (i - Container::OCCUPANCY_SPACING) / 60;
+                state->statusString = "AUTO-EJECT IN " + std::to_string(secondsLeft);
             }
         }
     } 
     else if(state->tick >= state->historyBuffer()[container->id].size())
     {
-        container->nextState.boxOccupied = false;
-        container->nextState.attachedObjectId = -1;
+        container->nextState().boxOccupied = false;
+        container->nextState().attachedObjectId = -1;
     }
     else
     {
-        container->nextState = state->historyBuffer()[container->id][state->tick];
+        container->nextState() = state->historyBuffer()[container->id][state->tick];
     }
 }
 
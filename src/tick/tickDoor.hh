@@ -1,13 +0,0 @@
-#ifndef __TICKDOOR_HH__
-#define __TICKDOOR_HH__
-
-#include <state/GameState.hh>
-#include <objects/Door.hh>
-
-namespace tick{
-
-void tickDoor(GameState * state, Door* door);
-
-}
-
-#endif
\ No newline at end of file
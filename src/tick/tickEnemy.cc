@@ -5,32 +5,19 @@ namespace tick{
 void createCrime(GameState * state, Enemy* enemy, Crime::CrimeType crimeType, GameObject* subject)
 {
     //Check if this report matches an existing crime in this enemy's alarm
-    for(Crime * crime : state->crimes())
+    Crime * existing = state->crimeIndex().findActive(enemy->assignedAlarm, crimeType, subject->id, enemy->backwards, state->tick);
+    if(existing != nullptr)
     {
-        if(!crime->activeAt(state->tick) || crime->backwards != enemy->backwards)
+        if(existing->crimeType == Crime::TRESPASSING)
         {
-            continue;
+            existing->nextState().pos = subject->state().pos;
+            existing->nextState().targetVisible = true;
+            existing->clearSearch();
         }
-        if(crime->assignedAlarm != enemy->assignedAlarm)
-        {
-            continue;
-        }
-
-
-        if(crime->crimeType == crimeType
-           && crime->subjectId == subject->id)
-        {
-            if(crime->crimeType == Crime::TRESPASSING)
-            {
-                crime->nextState.pos = subject->state.pos;
-                crime->nextState.targetVisible = true;
-                crime->nextState.searchStatus = 0;
-            }
-            //Murder does not need to be updated based on the enemy still seeing the body
+        //Murder does not need to be updated based on the enemy still seeing the body
 
-            //Found an existing matching crime, nothing more needs to be done
-            return;
-        }
+        //Found an existing matching crime, nothing more needs to be done
+        return;
     }
 
     int alarmId = enemy->assignedAlarm;
@@ -43,15 +30,15 @@ void createCrime(GameState * state, Enemy* enemy, Crime::CrimeType crimeType, Ga
 
 
 
-    std::shared_ptr<Crime> crime(new Crime(state->nextID()));
-    crime->state.pos = subject->state.pos;
+    std::shared_ptr<Crime> crime = makeObject<Crime>(state->nextID());
+    crime->state().pos = subject->state().pos;
     crime->crimeType = crimeType;
     crime->subjectId = subject->id;
     crime->assignedAlarm = alarmId;
-    crime->state.targetVisible = true;
+    crime->state().targetVisible = true;
     crime->initialTimeline = state->currentTimeline();
     crime->backwards = enemy->backwards;
-    crime->nextState = crime->state;
+    crime->nextState() = crime->state();
     if(enemy->backwards)
     {
         crime->ending = state->tick;
@@ -62,15 +49,13 @@ void createCrime(GameState * state, Enemy* enemy, Crime::CrimeType crimeType, Ga
         crime->beginning = state->tick;
     }
 
-    state->crimes().push_back(crime.get());
-    state->objects()[crime->id] = crime;
-    state->historyBuffer().buffer[crime->id] = std::vector<ObjectState>(state->tick+1);
-    state->historyBuffer().buffer[crime->id][state->tick] = crime->state;
+    state->spawnObject(crime);
+    state->alarmMembership.crimeReported(crime.get());
 
     std::cout << "Crime " << crime->id << " created on tick " << state->tick << " under alarm " << alarmId << std::endl;
 }
 
-void reportCrimes(GameState * state, Enemy* enemy)
+void reportCrimes(GameState * state, Enemy* enemy, EnemyCommandBuffer & commands)
 {
     //Trespassing
     for(Player* player : state->players())
@@ -79,9 +64,9 @@ void reportCrimes(GameState * state, Enemy* enemy)
         {
             continue;
         }
-        if(playerVisibleToEnemy(state, player, enemy))
+        if(playerVisibleToEnemy(state, player, enemy, playerInView(state, player, enemy)))
         {
-            createCrime(state, enemy, Crime::TRESPASSING, player);   
+            commands.push_back(EnemyCommand::reportCrime(Crime::TRESPASSING, player->id));
         }
     }
 
@@ -89,33 +74,33 @@ void reportCrimes(GameState * state, Enemy* enemy)
     for(Enemy* other : state->enemies())
     {
         if(other->activeAt(state->tick) 
-            && other->state.aiState == Enemy::AI_DEAD
-            && !other->state.discovered
-            && pointVisibleToEnemy(state, other->state.pos, enemy))
+            && other->state().aiState == Enemy::AI_DEAD
+            && !other->state().discovered
+            && pointVisibleToEnemy(state, other->state().pos, enemy))
         {
-            createCrime(state, enemy, Crime::MURDER, other);
+            commands.push_back(EnemyCommand::reportCrime(Crime::MURDER, other->id));
             //Note this may cause problems if there are enemies with opposite arrows of time
-            other->nextState.discovered = true;
+            commands.push_back(EnemyCommand::markDiscovered(other->id));
         }
     }
 }
 
-void reportSearches(GameState * state, Enemy* enemy)
+void reportSearches(GameState * state, Enemy* enemy, EnemyCommandBuffer & commands)
 {
     if(enemy->assignedAlarm == -1)
     {
         return;
     }
 
-    Alarm * alarm = dynamic_cast<Alarm*>(state->objects().at(enemy->assignedAlarm).get());
+    Alarm * alarm = objectCast<Alarm>(state->objects().at(enemy->assignedAlarm).get());
     for(int crimeId : alarm->crimes)
     {
-        Crime * crime = dynamic_cast<Crime*>(state->objects().at(crimeId).get());
+        Crime * crime = objectCast<Crime>(state->objects().at(crimeId).get());
         if(!crime->activeAt(state->tick) || crime->backwards != state->backwards())
         {
             continue;
         }
-        if(crime->state.targetVisible)
+        if(crime->state().targetVisible)
         {
             //Crimes can't be searched while the target is still visible
             //(only really applies to Trespassing)
@@ -130,34 +115,22 @@ void reportSearches(GameState * state, Enemy* enemy)
                 {
                     continue;
                 }
-                point_t crimePos = state->level->toLevelCoords(crime->state.pos);
+                point_t crimePos = state->level->toLevelCoords(crime->state().pos);
                 point_t searchPos = crimePos + point_t(x, y);
                 if(searchPos.x < 0 || searchPos.x >= state->level->width || searchPos.y < 0 || searchPos.y >= state->level->height)
                 {
                     //Out of bounds, so just check it off
-                    crime->submitSearch(x, y);
+                    commands.push_back(EnemyCommand::submitSearch(crime->id, x, y, false));
                 }
                 else if(state->obstructionGrid[searchPos.x][searchPos.y])
                 {
                     //Obstructed, so just check it off
-                    crime->submitSearch(x, y);
+                    commands.push_back(EnemyCommand::submitSearch(crime->id, x, y, false));
                 }
-                else if(pointVisibleToEnemy(state, state->level->fromLevelCoords(searchPos), enemy))
+                else if(enemySeesCell(state, enemy, searchPos))
                 {
-                    crime->submitSearch(x, y);
-                    if(crime->nextState.searchStatus == Crime::FULLY_SEARCHED())
-                    {
-                        std::cout << "Crime " << crime->id << " finished on tick " << state->tick << std::endl;
-                        if(crime->backwards)
-                        {
-                            crime->beginning = state->tick;
-                        }
-                        else
-                        {
-                            crime->hasEnding = true;
-                            crime->ending = state->tick;
-                        }
-                    }
+                    //Only searches the enemy actually sees can finish off the crime
+                    commands.push_back(EnemyCommand::submitSearch(crime->id, x, y, true));
                 }
                 else
                 {
@@ -166,13 +139,13 @@ void reportSearches(GameState * state, Enemy* enemy)
                     //Check if it's not easily navigable
                     point_t navResult = search::navigate(
                         state,
-                        crime->state.pos,
+                        crime->state().pos,
                         state->level->fromLevelCoords(searchPos),
                         ALLOWABLE_DISTANCE * state->level->scale);
 
-                    if(navResult == crime->state.pos)
+                    if(navResult == crime->state().pos)
                     {
-                        crime->submitSearch(x, y);
+                        commands.push_back(EnemyCommand::submitSearch(crime->id, x, y, false));
                     }
                 }
             }
@@ -201,16 +174,16 @@ float crimePriority(GameState * state, Crime* crime, Enemy* enemy)
         priority = BASE_PRIORITY * MURDER_MULTIPLIER;
     }
 
-    if(crime->state.targetVisible)
+    if(crime->state().targetVisible)
     {
         priority *= TARGET_VISIBLE_MULTIPLIER;
     }
 
-    priority -= math_util::dist(enemy->state.pos, crime->state.pos) * DISTANCE_MULTIPLIER;
+    priority -= math_util::dist(enemy->state().pos, crime->state().pos) * DISTANCE_MULTIPLIER;
 
     priority -= abs(math_util::angleDiff(
-        math_util::angleBetween(enemy->state.pos, crime->state.pos),
-        enemy->state.angle_deg)) * ANGLE_MULTIPLIER;
+        math_util::angleBetween(enemy->state().pos, crime->state().pos),
+        enemy->state().angle_deg)) * ANGLE_MULTIPLIER;
 
     return priority;
 }
@@ -222,109 +195,227 @@ float searchPriority(GameState * state, point_t pos, Enemy* enemy)
 
     float priority = 0;
 
-    priority -= math_util::dist(enemy->state.pos, pos) * DISTANCE_MULTIPLIER;
+    priority -= math_util::dist(enemy->state().pos, pos) * DISTANCE_MULTIPLIER;
 
     priority -= abs(math_util::angleDiff(
-        math_util::angleBetween(enemy->state.pos, pos),
-        enemy->state.angle_deg)) * ANGLE_MULTIPLIER;
+        math_util::angleBetween(enemy->state().pos, pos),
+        enemy->state().angle_deg)) * ANGLE_MULTIPLIER;
 
     return priority;
 }
 
 bool pointVisibleToEnemy(GameState * state, point_t point, Enemy * enemy)
 {
-    bool visible = true;
-
-    float angleToPoint = math_util::angleBetween(enemy->state.pos, point);
-    float angleDiff = math_util::angleDiff(enemy->state.angle_deg, angleToPoint);
+    float angleToPoint = math_util::angleBetween(enemy->state().pos, point);
+    float angleDiff = math_util::angleDiff(enemy->state().angle_deg, angleToPoint);
 
     //Within view angle of enemy
-    visible &= (std::abs(angleDiff) < (Enemy::VIEW_ANGLE / 2.0f));
+    if(!(std::abs(angleDiff) < (Enemy::VIEW_ANGLE / 2.0f)))
+    {
+        return false;
+    }
     //Close enough to see
-    visible &= (math_util::dist(enemy->state.pos, point) < Enemy::VIEW_RADIUS);
-    //Not obstructed
-    visible &= search::checkVisibility(state, enemy->state.pos, enemy->radius(), point, 0);
-
-    return visible;
+    if(!(math_util::dist(enemy->state().pos, point) < Enemy::VIEW_RADIUS))
+    {
+        return false;
+    }
+    //Not obstructed. Only worth checking once the cheap tests pass
+    return search::checkVisibility(state, enemy->state().pos, enemy->radius(), point, 0);
 }
 
 bool playerVisibleToEnemy(GameState * state, Player* player, Enemy* enemy)
 {
-    return player->state.visible && pointVisibleToEnemy(state, player->state.pos, enemy);
+    return player->state().visible && pointVisibleToEnemy(state, player->state().pos, enemy);
+}
+
+bool playerVisibleToEnemy(GameState * state, Player* player, Enemy* enemy, math_util::BatchResult inView)
+{
+    if(inView == math_util::OUTSIDE)
+    {
+        return false;
+    }
+    else if(inView == math_util::INSIDE)
+    {
+        return player->state().visible && search::checkVisibility(state, enemy->state().pos, enemy->radius(), player->state().pos, 0);
+    }
+    return playerVisibleToEnemy(state, player, enemy);
+}
+
+void addToViewBatch(math_util::ConeBatch & batch, Enemy* enemy, point_t point)
+{
+    batch.add(enemy->state().pos, enemy->state().angle_deg, point);
+}
+
+math_util::BatchResult playerInView(GameState * state, Player* player, Enemy* enemy)
+{
+    std::vector<Player*> & players = state->players();
+    std::vector<math_util::BatchResult> & inView = state->threatMap.raster(enemy->id).playersInView;
+    if(inView.empty())
+    {
+        math_util::ConeBatch batch;
+        for(Player* other : players)
+        {
+            addToViewBatch(batch, enemy, other->state().pos);
+        }
+        math_util::coneTest(batch, Enemy::VIEW_ANGLE / 2.0f, Enemy::VIEW_RADIUS, inView);
+    }
+
+    for(size_t i = 0; i < players.size(); i++)
+    {
+        if(players[i] == player)
+        {
+            return inView[i];
+        }
+    }
+    return math_util::UNSURE;
 }
 
 void navigateEnemy(GameState * state, Enemy* enemy, point_t target)
 {
-    point_t moveToward = search::navigate(state, enemy->state.pos, target);
+    point_t moveToward = search::navigate(state, enemy->state().pos, target);
     //If already at destination, or navigation failed, don't move
-    if(moveToward == enemy->state.pos)
+    if(moveToward == enemy->state().pos)
     {
         return;
     }
 
-    point_t moveVec = math_util::normalize(moveToward - enemy->state.pos);
+    point_t moveVec = math_util::normalize(moveToward - enemy->state().pos);
 
     for(Enemy * enemy2 : state->enemies())
     {
         if(enemy2 != enemy 
-           && enemy2->state.aiState != Enemy::AI_DEAD 
-           && math_util::dist(enemy->state.pos, enemy2->state.pos) < enemy->radius() * 2)
+           && enemy2->state().aiState != Enemy::AI_DEAD 
+           && math_util::dist(enemy->state().pos, enemy2->state().pos) < enemy->radius() * 2)
         {
-            moveVec += 0.5f * math_util::normalize(enemy->state.pos - enemy2->state.pos);
+            moveVec += 0.5f * math_util::normalize(enemy->state().pos - enemy2->state().pos);
             moveVec = math_util::normalize(moveVec);
         }
     }
     
-    enemy->nextState.pos += moveVec * enemy->state.speed;
-    enemy->nextState.angle_deg = math_util::rotateTowardsPoint(enemy->state.angle_deg, enemy->state.pos, moveToward, 5.0f);
+    enemy->nextState().pos += moveVec * enemy->state().speed;
+    enemy->nextState().angle_deg = math_util::rotateTowardsPoint(enemy->state().angle_deg, enemy->state().pos, moveToward, 5.0f);
 
-    if(search::checkObstruction(state, enemy->nextState.pos) && !search::checkObstruction(state, enemy->state.pos))
+    if(search::checkObstruction(state, enemy->nextState().pos) && !search::checkObstruction(state, enemy->state().pos))
     {
-        enemy->nextState.pos = enemy->state.pos;
+        enemy->nextState().pos = enemy->state().pos;
     }
 }
 
-void tickEnemy(GameState * state, Enemy* enemy)
+void resetThreatMap(GameState * state)
 {
-    if(!enemy->activeAt(state->tick))
+    std::vector<int> enemyIds;
+    for(Enemy* enemy : state->enemies())
     {
-        return;
+        enemyIds.push_back(enemy->id);
+    }
+    state->threatMap.reset(enemyIds);
+}
+
+bool enemySeesCell(GameState * state, Enemy* enemy, point_t cell)
+{
+    ThreatMap::Raster & raster = state->threatMap.raster(enemy->id);
+    if(!raster.started())
+    {
+        //Far enough from the enemy's cell that every cell whose center is in view range is covered
+        int reach = (int)std::ceil(Enemy::VIEW_RADIUS / state->level->scale) + 1;
+        point_t enemyCell = state->level->toLevelCoords(enemy->state().pos);
+        raster.start(enemyCell.x - reach, enemyCell.y - reach, 2 * reach + 1);
     }
 
-    if(enemy->backwards != state->backwards())
+    if(!raster.inside(cell.x, cell.y))
     {
-        enemy->nextState = state->historyBuffer()[enemy->id][state->tick];
-        return;
+        return pointVisibleToEnemy(state, state->level->fromLevelCoords(cell), enemy);
+    }
+    ThreatMap::CellState & seen = raster.at(cell.x, cell.y);
+    if(seen == ThreatMap::UNKNOWN)
+    {
+        seen = pointVisibleToEnemy(state, state->level->fromLevelCoords(cell), enemy) ? ThreatMap::SEEN : ThreatMap::UNSEEN;
     }
+    return seen == ThreatMap::SEEN;
+}
 
-    for(auto promise: state->promises)
+void buildThreatMap(GameState * state)
+{
+    resetThreatMap(state);
+
+    //Dead enemies don't see anything
+    std::vector<Enemy*> watchers;
+    for(Enemy* enemy : state->enemies())
     {
-        if(promise->target == enemy->id && promise->type == Promise::ABSENCE && promise->activatedTimeline < 0)
+        if(enemy->activeAt(state->tick) && enemy->state().aiState != Enemy::AI_DEAD)
         {
-            enemy->nextState.visible = false;
-            return;
+            watchers.push_back(enemy);
         }
     }
 
-    enemy->nextState.visible = true;
+    JobSystem::get().parallelFor(watchers.size(), 1, [&](int i)
+    {
+        Enemy* enemy = watchers[i];
+        //Starts the raster
+        enemySeesCell(state, enemy, state->level->toLevelCoords(enemy->state().pos));
+        ThreatMap::Raster & raster = state->threatMap.raster(enemy->id);
+        for(int x = raster.originX; x < raster.originX + raster.size; x++)
+        {
+            for(int y = raster.originY; y < raster.originY + raster.size; y++)
+            {
+                if(state->level->levelCoordsInBounds(point_t(x, y)))
+                {
+                    enemySeesCell(state, enemy, point_t(x, y));
+                }
+            }
+        }
+    });
+
+    VisibilityGrid & combined = state->threatMap.combined();
+    combined.assign(state->level->width, std::vector<bool>(state->level->height, false));
+    for(Enemy* enemy : watchers)
+    {
+        ThreatMap::Raster & raster = state->threatMap.raster(enemy->id);
+        for(int x = raster.originX; x < raster.originX + raster.size; x++)
+        {
+            for(int y = raster.originY; y < raster.originY + raster.size; y++)
+            {
+                if(state->level->levelCoordsInBounds(point_t(x, y)) && raster.at(x, y) == ThreatMap::SEEN)
+                {
+                    combined[x][y] = true;
+                }
+            }
+        }
+    }
+}
+
+void tickEnemy(GameState * state, Enemy* enemy, EnemyCommandBuffer & commands)
+{
+    if(!enemy->activeAt(state->tick))
+    {
+        return;
+    }
+
+    if(state->promises.hasPending(enemy->id, Promise::ABSENCE))
+    {
+        enemy->nextState().visible = false;
+        return;
+    }
 
-    if(enemy->state.aiState != Enemy::AI_DEAD)
+    enemy->nextState().visible = true;
+
+    if(enemy->state().aiState != Enemy::AI_DEAD)
     {
-        reportCrimes(state, enemy);
-        reportSearches(state, enemy);
+        reportCrimes(state, enemy, commands);
+        reportSearches(state, enemy, commands);
     }
 
-    if(enemy->state.aiState == Enemy::AI_CHASE || enemy->state.aiState == Enemy::AI_SEARCH)
+    if(enemy->state().aiState == Enemy::AI_CHASE || enemy->state().aiState == Enemy::AI_SEARCH)
     {
-        enemy->nextState.speed = Enemy::RUN_SPEED;
+        enemy->nextState().speed = Enemy::RUN_SPEED;
     }
     else
     {
-        enemy->nextState.speed = Enemy::WALK_SPEED;
+        enemy->nextState().speed = Enemy::WALK_SPEED;
     }
 
 
-    enemy->nextState.animIdx = enemy->state.aiState;
+    enemy->nextState().animIdx = enemy->state().aiState;
 
     for(Bullet* bullet: state->bullets())
     {
@@ -337,9 +428,9 @@ void tickEnemy(GameState * state, Enemy* enemy)
             continue;
         }
 
-        if(enemy->state.aiState != Enemy::AI_DEAD && enemy->isColliding(*bullet))
+        if(enemy->state().aiState != Enemy::AI_DEAD && enemy->isColliding(*bullet))
         {
-            enemy->nextState.aiState = Enemy::AI_DEAD;
+            enemy->nextState().aiState = Enemy::AI_DEAD;
         }
     }
     for(Throwable* throwable: state->throwables())
@@ -350,121 +441,121 @@ void tickEnemy(GameState * state, Enemy* enemy)
         }
 
         if(throwable->deadly 
-            && (throwable->state.aiState == Throwable::THROWN || throwable->state.aiState == Throwable::USED)
-            && enemy->state.aiState != Enemy::AI_DEAD
+            && (throwable->state().aiState == Throwable::THROWN || throwable->state().aiState == Throwable::USED)
+            && enemy->state().aiState != Enemy::AI_DEAD
             && enemy->isColliding(*throwable))
         {
-            enemy->nextState.aiState = Enemy::AI_DEAD;
+            enemy->nextState().aiState = Enemy::AI_DEAD;
         }
     }
 
-    if(enemy->state.aiState == Enemy::AI_PATROL)
+    if(enemy->state().aiState == Enemy::AI_PATROL)
     {
-        if(math_util::dist(enemy->state.pos, enemy->patrolPoints[enemy->state.patrolIdx]) <= state->level->scale / 3)
+        if(math_util::dist(enemy->state().pos, enemy->patrolPoints()[enemy->state().patrolIdx]) <= state->level->scale / 3)
         {
-            enemy->nextState.patrolIdx = (enemy->state.patrolIdx + 1) % enemy->patrolPoints.size();
+            enemy->nextState().patrolIdx = (enemy->state().patrolIdx + 1) % enemy->patrolPoints().size();
         }
 
-        navigateEnemy(state, enemy, enemy->patrolPoints[enemy->state.patrolIdx]);
+        navigateEnemy(state, enemy, enemy->patrolPoints()[enemy->state().patrolIdx]);
 
         if(enemy->assignedAlarm != -1)
         {
-            Alarm * alarm = dynamic_cast<Alarm*>(state->objects().at(enemy->assignedAlarm).get());
+            Alarm * alarm = objectCast<Alarm>(state->objects().at(enemy->assignedAlarm).get());
             if(alarm->crimes.size() > 0)
             {
-                enemy->nextState.aiState = Enemy::AI_SEARCH;
+                enemy->nextState().aiState = Enemy::AI_SEARCH;
             }
         }
 
         //Check if a player is seen
         for(Player* player : state->players())
         {
-            if(playerVisibleToEnemy(state, player, enemy))
+            if(playerVisibleToEnemy(state, player, enemy, playerInView(state, player, enemy)))
             {
-                enemy->nextState.aiState = Enemy::AI_CHASE;
-                enemy->nextState.targetId = player->id;
-                enemy->nextState.lastSeen = player->state.pos;
+                enemy->nextState().aiState = Enemy::AI_CHASE;
+                enemy->nextState().targetId = player->id;
+                enemy->nextState().lastSeen = player->state().pos;
                 break;
             }
         }
     }
-    else if(enemy->state.aiState == Enemy::AI_CHASE)
+    else if(enemy->state().aiState == Enemy::AI_CHASE)
     {
-        Player* target = dynamic_cast<Player*>(state->objects().at(enemy->state.targetId).get());
+        Player* target = objectCast<Player>(state->objects().at(enemy->state().targetId).get());
         if(!target->activeAt(state->tick))
         {
             if(enemy->assignedAlarm != -1)
             {
-                Alarm * alarm = dynamic_cast<Alarm*>(state->objects().at(enemy->assignedAlarm).get());
+                Alarm * alarm = objectCast<Alarm>(state->objects().at(enemy->assignedAlarm).get());
                 if(alarm->crimes.size() > 0)
                 {
-                    enemy->nextState.aiState = Enemy::AI_SEARCH;
+                    enemy->nextState().aiState = Enemy::AI_SEARCH;
                 }
                 else
                 {
-                    enemy->nextState.aiState = Enemy::AI_PATROL;
+                    enemy->nextState().aiState = Enemy::AI_PATROL;
                 }
             }
             else
             {
-                enemy->nextState.aiState = Enemy::AI_PATROL;
+                enemy->nextState().aiState = Enemy::AI_PATROL;
             }
             return;
         }
 
-        if(playerVisibleToEnemy(state, target, enemy))
+        if(playerVisibleToEnemy(state, target, enemy, playerInView(state, target, enemy)))
         {
-            enemy->nextState.lastSeen = target->state.pos;
-            if(math_util::dist(enemy->state.pos, target->state.pos) < Enemy::ATTACK_RADIUS)
+            enemy->nextState().lastSeen = target->state().pos;
+            if(math_util::dist(enemy->state().pos, target->state().pos) < Enemy::ATTACK_RADIUS)
             {
-                enemy->nextState.aiState = Enemy::AI_ATTACK;
+                enemy->nextState().aiState = Enemy::AI_ATTACK;
             }
             else
             {
-                navigateEnemy(state, enemy, target->state.pos);
+                navigateEnemy(state, enemy, target->state().pos);
             }
         }
         else
         {
-            if(math_util::dist(enemy->state.pos, enemy->state.lastSeen) < enemy->state.speed)
+            if(math_util::dist(enemy->state().pos, enemy->state().lastSeen) < enemy->state().speed)
             {
                 if(enemy->assignedAlarm != -1)
                 {
-                    Alarm * alarm = dynamic_cast<Alarm*>(state->objects().at(enemy->assignedAlarm).get());
+                    Alarm * alarm = objectCast<Alarm>(state->objects().at(enemy->assignedAlarm).get());
                     if(alarm->crimes.size() > 0)
                     {
-                        enemy->nextState.aiState = Enemy::AI_SEARCH;
+                        enemy->nextState().aiState = Enemy::AI_SEARCH;
                     }
                     else
                     {
-                        enemy->nextState.aiState = Enemy::AI_PATROL;
+                        enemy->nextState().aiState = Enemy::AI_PATROL;
                     }
                 }
                 else
                 {
-                    enemy->nextState.aiState = Enemy::AI_PATROL;
+                    enemy->nextState().aiState = Enemy::AI_PATROL;
                 }
             }
             else
             {
-                navigateEnemy(state, enemy, enemy->state.lastSeen);
+                navigateEnemy(state, enemy, enemy->state().lastSeen);
             }
         }
     }
-    else if(enemy->state.aiState == Enemy::AI_ATTACK)
+    else if(enemy->state().aiState == Enemy::AI_ATTACK)
     {
-        Player* target = dynamic_cast<Player*>(state->objects().at(enemy->state.targetId).get());
+        Player* target = objectCast<Player>(state->objects().at(enemy->state().targetId).get());
         if(!target->activeAt(state->tick))
         {
-            enemy->nextState.aiState = Enemy::AI_PATROL;
+            enemy->nextState().aiState = Enemy::AI_PATROL;
             return;
         }
 
-        if(playerVisibleToEnemy(state, target, enemy))
+        if(playerVisibleToEnemy(state, target, enemy, playerInView(state, target, enemy)))
         {
-            enemy->nextState.lastSeen = target->state.pos;
+            enemy->nextState().lastSeen = target->state().pos;
 
-            point_t predictedTargetPos;// = target->state.pos + target->moveSpeed * math_util::dist(enemy->state.pos, target->state.pos) / Bullet::SPEED;
+            point_t predictedTargetPos;// = target->state().pos + target->moveSpeed * math_util::dist(enemy->state().pos, target->state().pos) / Bullet::SPEED;
             if(enemy->backwards)
             {
                 //Make sure I don't start using backwards enemies without supporting it here
@@ -473,101 +564,81 @@ void tickEnemy(GameState * state, Enemy* enemy)
             }
             if(target->beginning <= state->tick - 2)
             {
-                point_t previousTargetPos = state->historyBuffer().buffer[target->id][state->tick-2].pos;
-                point_t delta = target->state.pos - previousTargetPos;
+                point_t previousTargetPos = state->historyBuffer().buffer.at(target->id)[state->tick-2].pos;
+                point_t delta = target->state().pos - previousTargetPos;
 
                 //Assume a number of ticks to when the bullet hits them. Possibly this should vary by distance?
-                predictedTargetPos = target->state.pos + (delta * 20.0f);
+                predictedTargetPos = target->state().pos + (delta * 20.0f);
             }
             else
             {
-                predictedTargetPos = target->state.pos;
+                predictedTargetPos = target->state().pos;
             }
 
 
-            enemy->nextState.angle_deg = math_util::rotateTowardsPoint(enemy->state.angle_deg, enemy->state.pos, predictedTargetPos, 5.0f);
+            enemy->nextState().angle_deg = math_util::rotateTowardsPoint(enemy->state().angle_deg, enemy->state().pos, predictedTargetPos, 5.0f);
 
-            if(enemy->state.chargeTime >= Enemy::ATTACK_CHARGE_TIME)
+            if(enemy->state().chargeTime >= Enemy::ATTACK_CHARGE_TIME)
             {
-                point_t direction = math_util::normalize(target->state.pos - enemy->state.pos);
-                point_t bulletPos = enemy->state.pos + direction * enemy->size.x;
-                std::shared_ptr<Bullet> bullet(new Bullet(state->nextID()));
-                bullet->creatorId = enemy->id;
-                bullet->state.pos = bulletPos;
-                bullet->velocity = direction * Bullet::SPEED / 2.0f; //Enemy bullets are slower
-                bullet->state.angle_deg = math_util::angleBetween(enemy->state.pos, predictedTargetPos);
-                bullet->initialTimeline = state->currentTimeline();
-                bullet->backwards = enemy->backwards;
-                bullet->nextState = bullet->state;
-                if(enemy->backwards)
-                {
-                    bullet->ending = state->tick;
-                    bullet->hasEnding = true;
-                }
-                else
-                {
-                    bullet->beginning = state->tick;
-                }
-
-                state->bullets().push_back(bullet.get());
-                state->objects()[bullet->id] = bullet;
-                state->historyBuffer().buffer[bullet->id] = std::vector<ObjectState>(state->tick+1);
-                state->historyBuffer().buffer[bullet->id][state->tick] = bullet->state;
-
-                enemy->nextState.chargeTime = 0;
-
-                std::cout << "Enemy " << enemy->id << " fired bullet " << bullet->id << " on tick " << state->tick << std::endl;
+                point_t direction = math_util::normalize(target->state().pos - enemy->state().pos);
+                point_t bulletPos = enemy->state().pos + direction * enemy->size().x;
+                commands.push_back(EnemyCommand::fireBullet(
+                    bulletPos,
+                    direction * Bullet::SPEED / 2.0f, //Enemy bullets are slower
+                    math_util::angleBetween(enemy->state().pos, predictedTargetPos)));
+
+                enemy->nextState().chargeTime = 0;
             }
             //Continue an attack in progress as long as we can see the target
-            else if(enemy->state.chargeTime > 0)
+            else if(enemy->state().chargeTime > 0)
             {
-                enemy->nextState.chargeTime++;
+                enemy->nextState().chargeTime++;
             }
             //But if not shooting, close distance first if needed
-            else if(math_util::dist(enemy->state.pos, target->state.pos) > Enemy::CHASE_RADIUS)
+            else if(math_util::dist(enemy->state().pos, target->state().pos) > Enemy::CHASE_RADIUS)
             {
-                enemy->nextState.aiState = Enemy::AI_CHASE;
+                enemy->nextState().aiState = Enemy::AI_CHASE;
             }
             //If target is close enough, start charging
             else
             {
-                enemy->nextState.chargeTime++;
+                enemy->nextState().chargeTime++;
             }
 
-            navigateEnemy(state, enemy, target->state.pos);
+            navigateEnemy(state, enemy, target->state().pos);
         }
         else
         {
-            enemy->nextState.chargeTime = 0;
-            enemy->nextState.aiState = Enemy::AI_CHASE;
+            enemy->nextState().chargeTime = 0;
+            enemy->nextState().aiState = Enemy::AI_CHASE;
             //If there is another visible target, swap to that.
             for(Player* player : state->players())
             {
-                if(playerVisibleToEnemy(state, player, enemy))
+                if(playerVisibleToEnemy(state, player, enemy, playerInView(state, player, enemy)))
                 {
                     
-                    enemy->nextState.targetId = player->id;
-                    enemy->nextState.lastSeen = player->state.pos;
+                    enemy->nextState().targetId = player->id;
+                    enemy->nextState().lastSeen = player->state().pos;
                     break;
                 }
             }
         }
     }
-    else if(enemy->state.aiState == Enemy::AI_DEAD)
+    else if(enemy->state().aiState == Enemy::AI_DEAD)
     {
         //Do nothing
     }
-    else if(enemy->state.aiState == Enemy::AI_SEARCH)
+    else if(enemy->state().aiState == Enemy::AI_SEARCH)
     {
         if(enemy->assignedAlarm == -1)
         {
             throw std::runtime_error("Enemy " + std::to_string(enemy->id) + " in AI_SEARCH state without an assigned alarm");
         }
 
-        Alarm * alarm = dynamic_cast<Alarm*>(state->objects().at(enemy->assignedAlarm).get());
+        Alarm * alarm = objectCast<Alarm>(state->objects().at(enemy->assignedAlarm).get());
         if(alarm->crimes.size() == 0)
         {
-            enemy->nextState.aiState = Enemy::AI_PATROL;
+            enemy->nextState().aiState = Enemy::AI_PATROL;
         }
         else
         {
@@ -575,7 +646,7 @@ void tickEnemy(GameState * state, Enemy* enemy)
             Crime * bestCrime = nullptr;
             for(int crimeId : alarm->crimes)
             {
-                Crime * crime = dynamic_cast<Crime*>(state->objects().at(crimeId).get());
+                Crime * crime = objectCast<Crime>(state->objects().at(crimeId).get());
                 if(crimePriority(state, crime, enemy) > bestPriority)
                 {
                     bestPriority = crimePriority(state, crime, enemy);
@@ -589,10 +660,10 @@ void tickEnemy(GameState * state, Enemy* enemy)
             }
             
             bestPriority = -1e12;
-            point_t bestSearchPos = enemy->state.pos;
-            if(bestCrime->state.targetVisible)
+            point_t bestSearchPos = enemy->state().pos;
+            if(bestCrime->state().targetVisible)
             {
-                bestSearchPos = bestCrime->state.pos;
+                bestSearchPos = bestCrime->state().pos;
             }
             else
             {
@@ -604,7 +675,7 @@ void tickEnemy(GameState * state, Enemy* enemy)
                         {
                             continue;
                         }
-                        point_t searchPos = bestCrime->state.pos + (point_t(x * state->level->scale, y * state->level->scale));
+                        point_t searchPos = bestCrime->state().pos + (point_t(x * state->level->scale, y * state->level->scale));
                         float priority = searchPriority(state, searchPos, enemy);
                         if(priority > bestPriority)
                         {
@@ -621,19 +692,89 @@ void tickEnemy(GameState * state, Enemy* enemy)
         //Check if a player is seen
         for(Player* player : state->players())
         {
-            if(playerVisibleToEnemy(state, player, enemy))
+            if(playerVisibleToEnemy(state, player, enemy, playerInView(state, player, enemy)))
             {
-                enemy->nextState.aiState = Enemy::AI_CHASE;
-                enemy->nextState.targetId = player->id;
-                enemy->nextState.lastSeen = player->state.pos;
+                enemy->nextState().aiState = Enemy::AI_CHASE;
+                enemy->nextState().targetId = player->id;
+                enemy->nextState().lastSeen = player->state().pos;
                 break;
             }
         }
     }
     else
     {
-        throw std::runtime_error("Unknown AI state " + std::to_string(enemy->state.aiState) + " for enemy " + std::to_string(enemy->id));
+        throw std::runtime_error("Unknown AI state " + std::to_string(enemy->state().aiState) + " for enemy " + std::to_string(enemy->id));
+    }
+}
+
+void fireBullet(GameState * state, Enemy* enemy, const EnemyCommand & command)
+{
+    std::shared_ptr<Bullet> bullet = makeObject<Bullet>(state->nextID());
+    bullet->creatorId = enemy->id;
+    bullet->state().pos = command.pos;
+    bullet->velocity = command.velocity;
+    bullet->state().angle_deg = command.angle_deg;
+    bullet->initialTimeline = state->currentTimeline();
+    bullet->backwards = enemy->backwards;
+    bullet->nextState() = bullet->state();
+    if(enemy->backwards)
+    {
+        bullet->ending = state->tick;
+        bullet->hasEnding = true;
+    }
+    else
+    {
+        bullet->beginning = state->tick;
+    }
+
+    state->spawnObject(bullet);
+
+    std::cout << "Enemy " << enemy->id << " fired bullet " << bullet->id << " on tick " << state->tick << std::endl;
+}
+
+void submitSearch(GameState * state, const EnemyCommand & command)
+{
+    Crime * crime = state->getObject<Crime>(command.objectId);
+    crime->submitSearch(command.x, command.y);
+    if(command.canFinish && crime->willBeFullySearched())
+    {
+        std::cout << "Crime " << crime->id << " finished on tick " << state->tick << std::endl;
+        if(crime->backwards)
+        {
+            crime->beginning = state->tick;
+        }
+        else
+        {
+            crime->hasEnding = true;
+            crime->ending = state->tick;
+        }
+        //Otherwise it would stay on its alarm's list until the next rebuild, and enemies would keep searching it
+        state->alarmMembership.crimeEnded(crime);
+        //A new report of the same thing is a new crime
+        state->crimeIndex().remove(crime);
+    }
+}
+
+void applyEnemyCommands(GameState * state, Enemy* enemy, const EnemyCommandBuffer & commands)
+{
+    for(const EnemyCommand & command : commands)
+    {
+        switch(command.type)
+        {
+            case EnemyCommand::REPORT_CRIME:
+                createCrime(state, enemy, command.crimeType, state->objects().at(command.objectId).get());
+                break;
+            case EnemyCommand::MARK_DISCOVERED:
+                state->objects().at(command.objectId)->nextState().discovered = true;
+                break;
+            case EnemyCommand::SUBMIT_SEARCH:
+                submitSearch(state, command);
+                break;
+            case EnemyCommand::FIRE_BULLET:
+                fireBullet(state, enemy, command);
+                break;
+        }
     }
 }
 
-}
\ No newline at end of file
+}
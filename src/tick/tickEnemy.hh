@@ -6,14 +6,95 @@
 #include <objects/Enemy.hh>
 #include <objects/Player.hh>
 #include <procedures/Search.hh>
+#include <utils/JobSystem.hh>
+#include <utils/MathBatch.hh>
+
+#include <vector>
 
 namespace tick{
 
+//Something an enemy's tick does to the game state other than its own next state.
+//Enemies only write their own next state while ticking, so they can be ticked in parallel. Everything else
+//is held back in their command buffers and applied afterwards, one enemy at a time in tick order,
+//which gives the same results as ticking them one after another.
+struct EnemyCommand
+{
+    enum CommandType
+    {
+        REPORT_CRIME,
+        MARK_DISCOVERED,
+        SUBMIT_SEARCH,
+        FIRE_BULLET
+    };
+
+    static EnemyCommand reportCrime(Crime::CrimeType crimeType, int subjectId)
+    {
+        EnemyCommand command(REPORT_CRIME, subjectId);
+        command.crimeType = crimeType;
+        return command;
+    }
+
+    static EnemyCommand markDiscovered(int bodyId)
+    {
+        return EnemyCommand(MARK_DISCOVERED, bodyId);
+    }
+
+    static EnemyCommand submitSearch(int crimeId, int x, int y, bool canFinish)
+    {
+        EnemyCommand command(SUBMIT_SEARCH, crimeId);
+        command.x = x;
+        command.y = y;
+        command.canFinish = canFinish;
+        return command;
+    }
+
+    static EnemyCommand fireBullet(point_t pos, point_t velocity, float angle_deg)
+    {
+        EnemyCommand command(FIRE_BULLET, -1);
+        command.pos = pos;
+        command.velocity = velocity;
+        command.angle_deg = angle_deg;
+        return command;
+    }
+
+    CommandType type;
+    //Subject of a crime report, body that was discovered or crime that was searched
+    int objectId;
+
+    Crime::CrimeType crimeType;
+
+    //Search cell and whether this search can finish the crime
+    int x;
+    int y;
+    bool canFinish;
+
+    //New bullet
+    point_t pos;
+    point_t velocity;
+    float angle_deg;
+
+private:
+    EnemyCommand(CommandType _type, int _objectId)
+        : type(_type)
+        , objectId(_objectId)
+        , crimeType(Crime::MURDER)
+        , x(0)
+        , y(0)
+        , canFinish(false)
+        , pos(0, 0)
+        , velocity(0, 0)
+        , angle_deg(0)
+    {
+    }
+};
+
+typedef std::vector<EnemyCommand> EnemyCommandBuffer;
+
 void createCrime(GameState * state, Enemy* enemy, Crime::CrimeType crimeType, GameObject* subject);
 
-void reportCrimes(GameState * state, Enemy* enemy);
+void reportCrimes(GameState * state, Enemy* enemy, EnemyCommandBuffer & commands);
 
-void reportSearches(GameState * state, Enemy* enemy);
+void reportSearches(GameState * state, Enemy* enemy, EnemyCommandBuffer & commands);
 
 float crimePriority(GameState * state, Crime* crime, Enemy* enemy);
 
@@ -23,9 +104,37 @@ bool pointVisibleToEnemy(GameState * state, point_t point, Enemy* enemy);
 
 bool playerVisibleToEnemy(GameState * state, Player* player, Enemy* enemy);
 
+//The same as playerVisibleToEnemy, given what math_util::coneTest said about the enemy's view cone and the player
+bool playerVisibleToEnemy(GameState * state, Player* player, Enemy* enemy, math_util::BatchResult inView);
+
+//Add a pair to a batch for math_util::coneTest with the enemy's view cone
+void addToViewBatch(math_util::ConeBatch & batch, Enemy* enemy, point_t point);
+
+//All the players against the enemy's view cone in one go, for use during the enemy phase
+math_util::BatchResult playerInView(GameState * state, Player* player, Enemy* enemy);
+
 void navigateEnemy(GameState * state, Enemy* enemy, point_t target);
 
-void tickEnemy(GameState * state, Enemy* enemy);
+//Start a new tick's threat map. Enemies only look at other objects' committed states,
+//so what they can see holds for the whole enemy phase of a tick
+void resetThreatMap(GameState * state);
+
+//Whether the enemy can see the center of a cell, from state->threatMap if it has been asked before this tick.
+//Safe to call in parallel for different enemies
+bool enemySeesCell(GameState * state, Enemy* enemy, point_t cell);
+
+//Start a new threat map with every living enemy's whole raster filled in and combined, for the debug overlay
+void buildThreatMap(GameState * state);
+
+//Only writes the enemy's own next state, anything else goes into commands
+void tickEnemy(GameState * state, Enemy* enemy, EnemyCommandBuffer & commands);
+
+void fireBullet(GameState * state, Enemy* enemy, const EnemyCommand & command);
+
+void submitSearch(GameState * state, const EnemyCommand & command);
+
+//Carry out what the enemy's tick left in its command buffer
+void applyEnemyCommands(GameState * state, Enemy* enemy, const EnemyCommandBuffer & commands);
 
 }
 
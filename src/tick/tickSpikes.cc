@@ -2,43 +2,37 @@
 
 namespace tick{
 
-void tickSpikes(GameState * state, Spikes* spikes)
+void evaluateSpikes(GameState * state, Spikes* spikes, StateBuffer& states, const SpikesCycle& cycle)
 {
     if(!spikes->activeAt(state->tick))
     {
         return;
     }
 
-    if(spikes->backwards != state->backwards())
+    int pointInCycle = (state->tick + cycle.cycleOffset) % (cycle.downDuration + cycle.upDuration);
+    if(pointInCycle < cycle.downDuration)
     {
-        spikes->nextState = state->historyBuffer()[spikes->id][state->tick];
-        return;
-    }
-
-    int pointInCycle = (state->tick + spikes->cycleOffset) % (spikes->downDuration + spikes->upDuration);
-    if(pointInCycle < spikes->downDuration)
-    {
-        if(spikes->downDuration - pointInCycle < Spikes::WARNING_DURATION)
+        if(cycle.downDuration - pointInCycle < Spikes::WARNING_DURATION)
         {
-            spikes->nextState.aiState = Spikes::WARNING;
+            states.current().aiState = Spikes::WARNING;
         }
         else
         {
-            spikes->nextState.aiState = Spikes::DOWN;
+            states.current().aiState = Spikes::DOWN;
         }
     }
     else
     {
-        if(spikes->downDuration > 0 && (spikes->upDuration - (pointInCycle - spikes->downDuration) < Spikes::WARNING_DURATION))
+        if(cycle.downDuration > 0 && (cycle.upDuration - (pointInCycle - cycle.downDuration) < Spikes::WARNING_DURATION))
         {
-            spikes->nextState.aiState = Spikes::WARNING;
+            states.current().aiState = Spikes::WARNING;
         }
         else
         {
-            spikes->nextState.aiState = Spikes::UP;
+            states.current().aiState = Spikes::UP;
         }
     }
-    spikes->nextState.animIdx = spikes->nextState.aiState;
+    states.current().animIdx = states.current().aiState;
 }
 
 
@@ -6,7 +6,9 @@
 
 namespace tick{
 
-void tickSpikes(GameState * state, Spikes* spikes);
+//Set spikes' state on the current tick. This only depends on the tick, so spikes have no history
+//states and cycle are the spikes' row in the spikes table
+void evaluateSpikes(GameState * state, Spikes* spikes, StateBuffer& states, const SpikesCycle& cycle);
 
 }
 
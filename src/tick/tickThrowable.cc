@@ -2,143 +2,136 @@
 
 namespace tick{
 
-void tickThrowable(GameState * state, Throwable* throwable)
+void tickThrowable(GameState * state, Throwable* throwable, StateBuffer& states, const ThrowParams& params)
 {
     if(!throwable->activeAt(state->tick))
     {
         return;
     }
 
-    if(throwable->backwards != state->backwards())
-    {
-        //TODO we may want to have backwards throwables be usable in the future
-        throwable->nextState = state->historyBuffer()[throwable->id][state->tick];
-        return;
-    }
+    ObjectState& current = states.current();
+    ObjectState& next = states.next();
 
-    if(throwable->state.aiState == Throwable::STILL)
+    if(current.aiState == Throwable::STILL)
     {
         for(Player* player : state->players())
         {
-            if(player->state.willThrow
-                && math_util::dist(player->state.pos, throwable->state.pos) < (throwable->size.x + Player::INTERACT_RADIUS)
+            if(player->state().willThrow
+                && math_util::dist(player->state().pos, current.pos) < (throwable->size().x + Player::INTERACT_RADIUS)
                 && player->backwards == state->backwards()
-                && !player->state.holdingObject
-                && !(player->nextState.holdingObject && player->nextState.heldObjectId != throwable->id))
+                && !player->state().holdingObject
+                && !(player->nextState().holdingObject && player->nextState().heldObjectId != throwable->id))
             {
-                throwable->nextState.aiState = Throwable::HELD;
-                throwable->nextState.attachedObjectId = player->id;
-                player->nextState.heldObjectId = throwable->id;
-                player->nextState.holdingObject = true;
+                next.aiState = Throwable::HELD;
+                next.attachedObjectId = player->id;
+                player->nextState().heldObjectId = throwable->id;
+                player->nextState().holdingObject = true;
                 break;
             }
         }
     }
-    else if(throwable->state.aiState == Throwable::THROWN)
+    else if(current.aiState == Throwable::THROWN)
     {
-        point_t nextPos = math_util::moveInDirection(throwable->state.pos, throwable->state.angle_deg, throwable->state.speed);
+        point_t nextPos = math_util::moveInDirection(current.pos, current.angle_deg, current.speed);
         if(search::checkObstruction(state, nextPos))
         {
-            float bounceAngle = search::bounceOffWall(state, throwable->state.pos, nextPos);
-            throwable->nextState.angle_deg = bounceAngle;
-            throwable->nextState.speed *= throwable->bounciness;
-            throwable->nextState.pos = math_util::moveInDirection(throwable->state.pos, bounceAngle, throwable->nextState.speed);
+            float bounceAngle = search::bounceOffWall(state, current.pos, nextPos);
+            next.angle_deg = bounceAngle;
+            next.speed *= params.bounciness;
+            next.pos = math_util::moveInDirection(current.pos, bounceAngle, next.speed);
         }
         else
         {
-            throwable->nextState.pos = nextPos;
+            next.pos = nextPos;
         }
-        throwable->nextState.speed -= throwable->drag;
+        next.speed -= params.drag;
 
-        if(throwable->nextState.speed < 0.0f)
+        if(next.speed < 0.0f)
         {
-            throwable->nextState.aiState = Throwable::STILL;
-            throwable->nextState.speed = 0.0f;
+            next.aiState = Throwable::STILL;
+            next.speed = 0.0f;
         }
 
         for(Enemy* enemy : state->enemies())
         {
-            if(enemy->activeAt(state->tick) && enemy->state.aiState != Enemy::AI_DEAD && enemy->isColliding(*throwable))
+            if(enemy->activeAt(state->tick) && enemy->state().aiState != Enemy::AI_DEAD && enemy->isColliding(*throwable))
             {
-                throwable->nextState.aiState = Throwable::STILL;
-                throwable->nextState.speed = 0.0f;
+                next.aiState = Throwable::STILL;
+                next.speed = 0.0f;
                 break;
             }
         }
     }
-    else if(throwable->state.aiState == Throwable::HELD)
+    else if(current.aiState == Throwable::HELD)
     {
-        Player * holder = dynamic_cast<Player*>(state->objects().at(throwable->state.attachedObjectId).get());
-        throwable->nextState.pos = math_util::moveInDirection(holder->state.pos, holder->state.angle_deg - 30, holder->size.x);
+        Player * holder = objectCast<Player>(state->objects().at(current.attachedObjectId).get());
+        next.pos = math_util::moveInDirection(holder->state().pos, holder->state().angle_deg - 30, holder->size().x);
 
         if(throwable->type() == GameObject::GUN)
         {
-            throwable->nextState.angle_deg = math_util::angleBetween(throwable->state.pos, holder->state.aimPoint);
+            next.angle_deg = math_util::angleBetween(current.pos, holder->state().aimPoint);
         }
         else
         {
-            throwable->nextState.angle_deg = holder->state.angle_deg;
+            next.angle_deg = holder->state().angle_deg;
         }
 
-        if(holder->state.willFire && !holder->state.boxOccupied)
+        if(holder->state().willFire && !holder->state().boxOccupied)
         {
-            throwable->nextState.aiState = Throwable::USED;
-            throwable->nextState.chargeTime = 0;
+            next.aiState = Throwable::USED;
+            next.chargeTime = 0;
         }
-        else if(holder->state.willThrow && !holder->state.boxOccupied)
+        else if(holder->state().willThrow && !holder->state().boxOccupied)
         {
-            throwable->nextState.aiState = Throwable::THROWN;
-            throwable->nextState.attachedObjectId = -1;
-            holder->nextState.heldObjectId = -1;
-            holder->nextState.holdingObject = false;
-            throwable->nextState.speed = throwable->throwSpeed;
+            next.aiState = Throwable::THROWN;
+            next.attachedObjectId = -1;
+            holder->nextState().heldObjectId = -1;
+            holder->nextState().holdingObject = false;
+            next.speed = params.throwSpeed;
         }
     }
-    else if(throwable->state.aiState == Throwable::USED)
+    else if(current.aiState == Throwable::USED)
     {
-        throwable->nextState.chargeTime = throwable->state.chargeTime + 1;
-        if(throwable->nextState.chargeTime > throwable->useDuration)
+        next.chargeTime = current.chargeTime + 1;
+        if(next.chargeTime > params.useDuration)
         {
-            throwable->nextState.aiState = Throwable::HELD;
+            next.aiState = Throwable::HELD;
         }
 
-        Player * holder = dynamic_cast<Player*>(state->objects().at(throwable->state.attachedObjectId).get());
+        Player * holder = objectCast<Player>(state->objects().at(current.attachedObjectId).get());
 
-        throwable->nextState.pos = math_util::moveInDirection(holder->state.pos, holder->state.angle_deg - 30, holder->size.x);
-        throwable->nextState.angle_deg = holder->state.angle_deg;
+        next.pos = math_util::moveInDirection(holder->state().pos, holder->state().angle_deg - 30, holder->size().x);
+        next.angle_deg = holder->state().angle_deg;
 
         switch(throwable->type())
         {
             case GameObject::KNIFE:
             {
-                Knife * knife = dynamic_cast<Knife*>(throwable);
-
-                float animationProgress = knife->state.chargeTime / (float)knife->useDuration;
+                float animationProgress = current.chargeTime / (float)params.useDuration;
 
-                float angle = -40.0f * cos(animationProgress * M_PI * 2.0) + holder->state.angle_deg;
+                float angle = -40.0f * trig::cosDeg(animationProgress * 360.0f) + holder->state().angle_deg;
 
-                throwable->nextState.pos = math_util::moveInDirection(holder->state.pos, angle, holder->size.x);
-                throwable->nextState.angle_deg = angle;
+                next.pos = math_util::moveInDirection(holder->state().pos, angle, holder->size().x);
+                next.angle_deg = angle;
                 
                 break;
             }
             case GameObject::GUN:
             {
-                Gun * gun = dynamic_cast<Gun*>(throwable);
-                throwable->nextState.angle_deg = math_util::angleBetween(throwable->state.pos, holder->state.aimPoint);
+                next.angle_deg = math_util::angleBetween(current.pos, holder->state().aimPoint);
 
-                if(throwable->nextState.chargeTime == 1)
+                if(next.chargeTime == 1)
                 {
-                    point_t direction = math_util::normalize(holder->state.aimPoint - gun->state.pos);
-                    point_t bulletPos = gun->state.pos + direction * gun->size.x;
-                    std::shared_ptr<Bullet> bullet(new Bullet(state->nextID()));
+                    point_t direction = math_util::normalize(holder->state().aimPoint - current.pos);
+                    point_t bulletPos = current.pos + direction * throwable->size().x;
+                    std::shared_ptr<Bullet> bullet = makeObject<Bullet>(state->nextID());
                     bullet->creatorId = holder->id;
-                    bullet->state.pos = bulletPos;
+                    bullet->state().pos = bulletPos;
                     bullet->velocity = direction * Bullet::SPEED;
-                    bullet->state.angle_deg = math_util::angleBetween(gun->state.pos, holder->state.aimPoint);
+                    bullet->state().angle_deg = math_util::angleBetween(current.pos, holder->state().aimPoint);
                     bullet->initialTimeline = state->currentTimeline();
                     bullet->backwards = holder->backwards;
-                    bullet->nextState = bullet->state;
+                    bullet->nextState() = bullet->state();
                     if(holder->backwards)
                     {
                         bullet->ending = state->tick;
@@ -149,12 +142,9 @@ void tickThrowable(GameState * state, Throwable* throwable)
                         bullet->beginning = state->tick;
                     }
 
-                    holder->nextState.cooldown = holder->fireCooldown;
+                    holder->nextState().cooldown = holder->fireCooldown;
 
-                    state->bullets().push_back(bullet.get());
-                    state->objects()[bullet->id] = bullet;
-                    state->historyBuffer().buffer[bullet->id] = std::vector<ObjectState>(state->tick+1);
-                    state->historyBuffer().buffer[bullet->id][state->tick] = bullet->state;
+                    state->spawnObject(bullet);
 
                     std::cout << "Player " << holder->id << " fired bullet " << bullet->id << " on tick " << state->tick << std::endl;
                 }
@@ -8,7 +8,8 @@
 
 namespace tick{
 
-void tickThrowable(GameState * state, Throwable* throwable);
+//states and params are the throwable's row in the throwable table
+void tickThrowable(GameState * state, Throwable* throwable, StateBuffer& states, const ThrowParams& params);
 
 }
 
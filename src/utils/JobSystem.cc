@@ -0,0 +1,167 @@
+#include "JobSystem.hh"
+
+std::shared_ptr<JobSystem> JobSystem::instance;
+
+//Index of the pool worker running on this thread, or -1 for threads outside the pool
+static thread_local int t_workerIndex = -1;
+
+JobSystem::JobSystem(int workers)
+    : m_queued(0)
+    , m_quit(false)
+{
+    //One queue per worker plus one for everyone else
+    for(int i = 0; i <= workers; i++)
+    {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    for(int i = 0; i < workers; i++)
+    {
+        m_threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for(std::thread & thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+JobSystem& JobSystem::getInstance()
+{
+    if(instance.get() == nullptr)
+    {
+        //The thread asking for work also helps with it, so it counts as one of the cores
+        int cores = std::thread::hardware_concurrency();
+        instance.reset(new JobSystem(std::max(cores - 1, 0)));
+    }
+    return *instance;
+}
+
+void JobSystem::run(Group & group, Job job)
+{
+    group.m_pending++;
+    Job wrapped = [&group, job]()
+    {
+        try
+        {
+            job();
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(group.m_errorMutex);
+            if(!group.m_error)
+            {
+                group.m_error = std::current_exception();
+            }
+        }
+        group.m_pending--;
+    };
+
+    if(m_threads.empty())
+    {
+        wrapped();
+        return;
+    }
+
+    Queue & queue = *m_queues[ownQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(wrapped));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_queued++;
+    }
+    m_wake.notify_one();
+}
+
+void JobSystem::wait(Group & group)
+{
+    int queue = ownQueue();
+    while(group.m_pending > 0)
+    {
+        if(!runOne(queue))
+        {
+            //Whatever is left is already running on other threads
+            std::this_thread::yield();
+        }
+    }
+
+    if(group.m_error)
+    {
+        std::exception_ptr error = group.m_error;
+        group.m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void JobSystem::workerLoop(int index)
+{
+    t_workerIndex = index;
+    while(true)
+    {
+        if(runOne(index))
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this]() { return m_quit || m_queued > 0; });
+        if(m_quit)
+        {
+            return;
+        }
+    }
+}
+
+bool JobSystem::runOne(int queue)
+{
+    Job job;
+
+    //Newest job from our own queue, since its data is most likely to still be in cache
+    {
+        Queue & own = *m_queues[queue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if(!own.jobs.empty())
+        {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+        }
+    }
+
+    //Otherwise steal the oldest job from someone else
+    for(size_t i = 1; !job && i < m_queues.size(); i++)
+    {
+        Queue & other = *m_queues[(queue + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if(!other.jobs.empty())
+        {
+            job = std::move(other.jobs.front());
+            other.jobs.pop_front();
+        }
+    }
+
+    if(!job)
+    {
+        return false;
+    }
+    m_queued--;
+    job();
+    return true;
+}
+
+int JobSystem::ownQueue()
+{
+    if(t_workerIndex >= 0)
+    {
+        return t_workerIndex;
+    }
+    return m_queues.size() - 1;
+}
@@ -0,0 +1,140 @@
+#ifndef __JOB_SYSTEM_HH__
+#define __JOB_SYSTEM_HH__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//A pool of worker threads, one per core, that the tick phases hand independent work to.
+//Every thread has its own job queue. Threads take new work from the back of their own queue and,
+//when that runs dry, steal from the front of someone else's.
+//
+//Jobs must only write state that belongs to them. Whatever order they run in, callers combine
+//their results in a fixed order afterwards, so the simulation comes out the same on any number of cores.
+class JobSystem
+{
+public:
+    typedef std::function<void()> Job;
+
+    //Jobs that are waited on together
+    class Group
+    {
+    public:
+        Group()
+            : m_pending(0)
+        {
+        }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<int> m_pending;
+        std::mutex m_errorMutex;
+        std::exception_ptr m_error;
+    };
+
+    static JobSystem& get()
+    {
+        return getInstance();
+    }
+
+    ~JobSystem();
+
+    //Fork: queue a job as part of the group
+    void run(Group & group, Job job);
+
+    //Join: help with queued jobs until everything in the group has finished.
+    //Rethrows an exception if any of the group's jobs threw
+    void wait(Group & group);
+
+    //Run fn(i) for every i in [0, count), in jobs of up to grain indices each
+    //If any call throws, the exception from the lowest job is rethrown once they have all finished
+    template<typename F>
+    void parallelFor(int count, int grain, F fn)
+    {
+        grain = std::max(grain, 1);
+        int jobs = (count + grain - 1) / grain;
+        if(jobs <= 1 || m_threads.empty())
+        {
+            for(int i = 0; i < count; i++)
+            {
+                fn(i);
+            }
+            return;
+        }
+
+        Group group;
+        std::vector<std::exception_ptr> errors(jobs);
+        for(int job = 0; job < jobs; job++)
+        {
+            run(group, [&fn, &errors, job, grain, count]()
+            {
+                try
+                {
+                    int end = std::min(count, (job + 1) * grain);
+                    for(int i = job * grain; i < end; i++)
+                    {
+                        fn(i);
+                    }
+                }
+                catch(...)
+                {
+                    errors[job] = std::current_exception();
+                }
+            });
+        }
+        wait(group);
+
+        for(std::exception_ptr & error : errors)
+        {
+            if(error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    int threadCount()
+    {
+        return m_threads.size() + 1;
+    }
+
+protected:
+    JobSystem(int workers);
+
+    static std::shared_ptr<JobSystem> instance;
+    static JobSystem& getInstance();
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void workerLoop(int index);
+
+    //Run one queued job, preferring the given queue. Returns false if every queue was empty
+    bool runOne(int queue);
+
+    //Queue for the calling thread. Threads outside the pool share the last queue
+    int ownQueue();
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    //Workers sleep on this while there's nothing queued anywhere
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<int> m_queued;
+    bool m_quit;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef __MATH_BATCH_HH__
+#define __MATH_BATCH_HH__
+
+#include "MathUtil.hh"
+
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+//Cone and range tests for many pairs at once, with dot products and squared distances instead of atan2 and sqrt.
+//These round differently from the scalar tests in math_util, and the simulation has to come out the same
+//either way, so anything close enough to an edge for that to matter comes back UNSURE for the caller to check exactly.
+namespace math_util{
+    enum BatchResult : uint8_t
+    {
+        OUTSIDE = 0,
+        INSIDE = 1,
+        UNSURE = 2
+    };
+
+    //Pairs of a viewer and a target, as structure of arrays
+    struct ConeBatch
+    {
+        void add(point_t viewer, float angle_deg, point_t target)
+        {
+            viewerX.push_back(viewer.x);
+            viewerY.push_back(viewer.y);
+            targetX.push_back(target.x);
+            targetY.push_back(target.y);
+            //angleDiff only wraps once, so a facing outside [-180, 180] isn't a plain cone. Leave those to the exact test
+            if(angle_deg >= -180 && angle_deg <= 180)
+            {
+                facingX.push_back(trig::cosDeg(angle_deg));
+                facingY.push_back(trig::sinDeg(angle_deg));
+            }
+            else
+            {
+                facingX.push_back(0);
+                facingY.push_back(0);
+            }
+        }
+
+        size_t size() const
+        {
+            return viewerX.size();
+        }
+
+        void clear()
+        {
+            viewerX.clear();
+            viewerY.clear();
+            facingX.clear();
+            facingY.clear();
+            targetX.clear();
+            targetY.clear();
+        }
+
+        std::vector<float> viewerX;
+        std::vector<float> viewerY;
+        //Unit vector the viewer is facing, or zero if unknown
+        std::vector<float> facingX;
+        std::vector<float> facingY;
+        std::vector<float> targetX;
+        std::vector<float> targetY;
+    };
+
+    //Constants shared by every lane of coneTest
+    struct ConeLimits
+    {
+        ConeLimits(float halfAngle_deg, float radius)
+            : cosSquared(trig::cosDeg(halfAngle_deg) * trig::cosDeg(halfAngle_deg))
+            , innerRadiusSquared(radius * radius * (1 - MARGIN))
+            , outerRadiusSquared(radius * radius * (1 + MARGIN))
+        {
+        }
+
+        //How close to an edge counts as unsure, relative to the squared distance.
+        //Far more than float rounding in either the batched or the exact test can move a result
+        constexpr static float MARGIN = 1e-3f;
+        //Targets this close to the viewer don't have a meaningful direction
+        constexpr static float MIN_DISTANCE_SQUARED = 1e-4f;
+
+        float cosSquared;
+        float innerRadiusSquared;
+        float outerRadiusSquared;
+    };
+
+    static BatchResult coneTestOne(const ConeBatch & batch, size_t i, const ConeLimits & limits)
+    {
+        float vx = batch.targetX[i] - batch.viewerX[i];
+        float vy = batch.targetY[i] - batch.viewerY[i];
+        float distSquared = vx * vx + vy * vy;
+        float dot = vx * batch.facingX[i] + vy * batch.facingY[i];
+        float facingSquared = batch.facingX[i] * batch.facingX[i] + batch.facingY[i] * batch.facingY[i];
+
+        //Positive inside the cone, negative outside, without needing a square root
+        float cone = dot * std::abs(dot) - limits.cosSquared * distSquared;
+        float band = ConeLimits::MARGIN * distSquared;
+        bool directionKnown = facingSquared > 0.5f && distSquared > ConeLimits::MIN_DISTANCE_SQUARED;
+
+        if(distSquared > limits.outerRadiusSquared || (directionKnown && cone < -band))
+        {
+            return OUTSIDE;
+        }
+        if(distSquared < limits.innerRadiusSquared && directionKnown && cone > band)
+        {
+            return INSIDE;
+        }
+        return UNSURE;
+    }
+
+    //Is each target within radius of its viewer and within halfAngle_deg either side of where it's facing?
+    //The exact version of this is pointVisibleToEnemy's angleBetween/angleDiff and dist tests. halfAngle_deg must be under 90
+    static void coneTest(const ConeBatch & batch, float halfAngle_deg, float radius, std::vector<BatchResult> & results)
+    {
+        ConeLimits limits(halfAngle_deg, radius);
+        results.resize(batch.size());
+        size_t i = 0;
+
+#if defined(__AVX2__)
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        for(; i + 8 <= batch.size(); i += 8)
+        {
+            __m256 vx = _mm256_sub_ps(_mm256_loadu_ps(&batch.targetX[i]), _mm256_loadu_ps(&batch.viewerX[i]));
+            __m256 vy = _mm256_sub_ps(_mm256_loadu_ps(&batch.targetY[i]), _mm256_loadu_ps(&batch.viewerY[i]));
+            __m256 fx = _mm256_loadu_ps(&batch.facingX[i]);
+            __m256 fy = _mm256_loadu_ps(&batch.facingY[i]);
+            __m256 distSquared = _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy));
+            __m256 dot = _mm256_add_ps(_mm256_mul_ps(vx, fx), _mm256_mul_ps(vy, fy));
+            __m256 facingSquared = _mm256_add_ps(_mm256_mul_ps(fx, fx), _mm256_mul_ps(fy, fy));
+
+            __m256 cone = _mm256_sub_ps(_mm256_mul_ps(dot, _mm256_andnot_ps(signMask, dot)), _mm256_mul_ps(_mm256_set1_ps(limits.cosSquared), distSquared));
+            __m256 band = _mm256_mul_ps(_mm256_set1_ps(ConeLimits::MARGIN), distSquared);
+            __m256 directionKnown = _mm256_and_ps(
+                _mm256_cmp_ps(facingSquared, _mm256_set1_ps(0.5f), _CMP_GT_OQ),
+                _mm256_cmp_ps(distSquared, _mm256_set1_ps(ConeLimits::MIN_DISTANCE_SQUARED), _CMP_GT_OQ));
+
+            __m256 outside = _mm256_or_ps(
+                _mm256_cmp_ps(distSquared, _mm256_set1_ps(limits.outerRadiusSquared), _CMP_GT_OQ),
+                _mm256_and_ps(directionKnown, _mm256_cmp_ps(cone, _mm256_sub_ps(_mm256_setzero_ps(), band), _CMP_LT_OQ)));
+            __m256 inside = _mm256_and_ps(
+                _mm256_and_ps(_mm256_cmp_ps(distSquared, _mm256_set1_ps(limits.innerRadiusSquared), _CMP_LT_OQ), directionKnown),
+                _mm256_cmp_ps(cone, band, _CMP_GT_OQ));
+
+            int outsideBits = _mm256_movemask_ps(outside);
+            int insideBits = _mm256_movemask_ps(inside);
+            for(int lane = 0; lane < 8; lane++)
+            {
+                results[i + lane] = (outsideBits >> lane) & 1 ? OUTSIDE : ((insideBits >> lane) & 1 ? INSIDE : UNSURE);
+            }
+        }
+#elif defined(__SSE2__)
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        for(; i + 4 <= batch.size(); i += 4)
+        {
+            __m128 vx = _mm_sub_ps(_mm_loadu_ps(&batch.targetX[i]), _mm_loadu_ps(&batch.viewerX[i]));
+            __m128 vy = _mm_sub_ps(_mm_loadu_ps(&batch.targetY[i]), _mm_loadu_ps(&batch.viewerY[i]));
+            __m128 fx = _mm_loadu_ps(&batch.facingX[i]);
+            __m128 fy = _mm_loadu_ps(&batch.facingY[i]);
+            __m128 distSquared = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+            __m128 dot = _mm_add_ps(_mm_mul_ps(vx, fx), _mm_mul_ps(vy, fy));
+            __m128 facingSquared = _mm_add_ps(_mm_mul_ps(fx, fx), _mm_mul_ps(fy, fy));
+
+            __m128 cone = _mm_sub_ps(_mm_mul_ps(dot, _mm_andnot_ps(signMask, dot)), _mm_mul_ps(_mm_set1_ps(limits.cosSquared), distSquared));
+            __m128 band = _mm_mul_ps(_mm_set1_ps(ConeLimits::MARGIN), distSquared);
+            __m128 directionKnown = _mm_and_ps(
+                _mm_cmpgt_ps(facingSquared, _mm_set1_ps(0.5f)),
+                _mm_cmpgt_ps(distSquared, _mm_set1_ps(ConeLimits::MIN_DISTANCE_SQUARED)));
+
+            __m128 outside = _mm_or_ps(
+                _mm_cmpgt_ps(distSquared, _mm_set1_ps(limits.outerRadiusSquared)),
+                _mm_and_ps(directionKnown, _mm_cmplt_ps(cone, _mm_sub_ps(_mm_setzero_ps(), band))));
+            __m128 inside = _mm_and_ps(
+                _mm_and_ps(_mm_cmplt_ps(distSquared, _mm_set1_ps(limits.innerRadiusSquared)), directionKnown),
+                _mm_cmpgt_ps(cone, band));
+
+            int outsideBits = _mm_movemask_ps(outside);
+            int insideBits = _mm_movemask_ps(inside);
+            for(int lane = 0; lane < 4; lane++)
+            {
+                results[i + lane] = (outsideBits >> lane) & 1 ? OUTSIDE : ((insideBits >> lane) & 1 ? INSIDE : UNSURE);
+            }
+        }
+#endif
+
+        //Whatever doesn't fill a whole vector, or everything without SIMD
+        for(; i < batch.size(); i++)
+        {
+            results[i] = coneTestOne(batch, i, limits);
+        }
+    }
+}//end namespace math_util
+
+#endif
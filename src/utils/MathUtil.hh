@@ -1,17 +1,22 @@
 #ifndef __MATH_UTIL_HH__
 #define __MATH_UTIL_HH__
 
+#include "TrigTables.hh"
+
 #include <cmath>
 #include <SFML/System/Vector2.hpp>
 
 typedef sf::Vector2<float> point_t;
 
 namespace math_util{
+    //Square roots are left to std::sqrt, since IEEE 754 requires them to be correctly rounded everywhere.
+    //Trig isn't, so it goes through the tables in TrigTables.hh instead
+
     static float dist(point_t p1, point_t p2)
     {
         float dx = p2.x - p1.x;
         float dy = p2.y - p1.y;
-        return sqrt(dx * dx + dy * dy);
+        return std::sqrt(dx * dx + dy * dy);
     }
 
     template<typename T>
@@ -29,7 +34,7 @@ namespace math_util{
     template<typename T>
     static sf::Vector2<T> normalize(sf::Vector2<T> a)
     {
-        T mag = sqrt(a.x * a.x + a.y * a.y);
+        T mag = std::sqrt(a.x * a.x + a.y * a.y);
         if(mag == 0)
         {
             //Pick an arbitrary direction
@@ -41,12 +46,12 @@ namespace math_util{
     template<typename T>
     static T length(sf::Vector2<T> a)
     {
-        return sqrt(a.x * a.x + a.y * a.y);
+        return std::sqrt(a.x * a.x + a.y * a.y);
     }
 
     static float angleBetween(point_t a, point_t b)
     {
-        return atan2(b.y - a.y, b.x - a.x) * 180.0f / M_PI;
+        return trig::atan2Deg(b.y - a.y, b.x - a.x);
     }
 
     static float angleDiff(float a, float b)
@@ -95,7 +100,7 @@ namespace math_util{
 
     static point_t moveInDirection(point_t pos, float angle, float distance)
     {
-        return pos + point_t(cos(angle * M_PI / 180.0f) * distance, sin(angle * M_PI / 180.0f) * distance);
+        return pos + point_t(trig::cosDeg(angle) * distance, trig::sinDeg(angle) * distance);
     }
 }//end namespace math
 
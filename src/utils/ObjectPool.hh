@@ -0,0 +1,124 @@
+#ifndef __OBJECT_POOL_HH__
+#define __OBJECT_POOL_HH__
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+//Fixed-size blocks handed out from a free list. Memory is taken from the heap a slab at a time and never given back,
+//so things that are created and thrown away over and over (bullets, crimes, every object copied into a timeline
+//that's later popped) keep reusing the same blocks instead of scattering new allocations across a long session.
+class BlockPool
+{
+public:
+    constexpr static size_t BLOCKS_PER_SLAB = 64;
+
+    BlockPool(size_t blockSize, size_t alignment)
+        : m_blockSize(roundUp(std::max(blockSize, sizeof(FreeBlock)), alignment))
+        , m_alignment(alignment)
+        , m_freeList(nullptr)
+    {
+    }
+
+    void* take()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_freeList == nullptr)
+        {
+            addSlab();
+        }
+        FreeBlock* block = m_freeList;
+        m_freeList = block->next;
+        return block;
+    }
+
+    void give(void* ptr)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = m_freeList;
+        m_freeList = block;
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    static size_t roundUp(size_t size, size_t alignment)
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    void addSlab()
+    {
+        char* slab = static_cast<char*>(::operator new(m_blockSize * BLOCKS_PER_SLAB, std::align_val_t(m_alignment)));
+        m_slabs.push_back(slab);
+        //Pushed in reverse so blocks are handed out in address order
+        for(size_t i = BLOCKS_PER_SLAB; i > 0; i--)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * m_blockSize);
+            block->next = m_freeList;
+            m_freeList = block;
+        }
+    }
+
+    size_t m_blockSize;
+    size_t m_alignment;
+    FreeBlock* m_freeList;
+    std::vector<char*> m_slabs;
+    std::mutex m_mutex;
+};
+
+//Allocator with one BlockPool per type it allocates. Used with std::allocate_shared,
+//the object and its reference counts come out of one block of the pool for that object's type
+template<typename T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+
+    PoolAllocator() {}
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        if(n != 1)
+        {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(pool().take());
+    }
+
+    void deallocate(T* ptr, size_t n)
+    {
+        if(n != 1)
+        {
+            std::allocator<T>().deallocate(ptr, n);
+            return;
+        }
+        pool().give(ptr);
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const
+    {
+        return true;
+    }
+
+private:
+    static BlockPool & pool()
+    {
+        //Never destroyed, so objects that are released during shutdown still have somewhere to go
+        static BlockPool* pool = new BlockPool(sizeof(T), alignof(T));
+        return *pool;
+    }
+};
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef __SEARCH_MASK_HH__
+#define __SEARCH_MASK_HH__
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//Which cells of a square search zone have been searched, for offsets from -R to R on each axis.
+//The size is fixed at compile time, so the cells are packed into as many 64-bit words as they need.
+template <int R>
+class SearchMask
+{
+public:
+    constexpr static int RADIUS = R;
+    constexpr static int DIAMETER = 2 * R + 1;
+    constexpr static int CELLS = DIAMETER * DIAMETER;
+    constexpr static int WORDS = (CELLS + 63) / 64;
+
+    SearchMask()
+        : m_words{}
+    {
+    }
+
+    void set(int x, int y)
+    {
+        int idx = index(x, y);
+        m_words[idx / 64] |= uint64_t(1) << (idx % 64);
+    }
+
+    bool test(int x, int y) const
+    {
+        int idx = index(x, y);
+        return m_words[idx / 64] & (uint64_t(1) << (idx % 64));
+    }
+
+    //Number of searched cells
+    int count() const
+    {
+        int total = 0;
+        for(int i = 0; i < WORDS; i++)
+        {
+            total += std::popcount(m_words[i]);
+        }
+        return total;
+    }
+
+    bool full() const
+    {
+        for(int i = 0; i < WORDS; i++)
+        {
+            if(m_words[i] != fullWord(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator==(const SearchMask& other) const = default;
+
+    size_t hash() const
+    {
+        uint64_t h = 0;
+        for(int i = 0; i < WORDS; i++)
+        {
+            h = (h ^ m_words[i]) * 0x9E3779B97F4A7C15ull;
+        }
+        return h;
+    }
+
+private:
+    static int index(int x, int y)
+    {
+        if(x > R || x < -R || y > R || y < -R)
+        {
+            throw std::runtime_error("SearchMask: (" + std::to_string(x) + ", " + std::to_string(y) + ") is out of bounds");
+        }
+        return (x + R) * DIAMETER + (y + R);
+    }
+
+    //The value of a word once every cell in it has been searched. Only the last word can be partly used
+    constexpr static uint64_t fullWord(int word)
+    {
+        int bits = CELLS - word * 64;
+        if(bits >= 64)
+        {
+            return ~uint64_t(0);
+        }
+        return (uint64_t(1) << bits) - 1;
+    }
+
+    std::array<uint64_t, WORDS> m_words;
+};
+
+//Every distinct mask something has referred to, each stored once so it can be referred to by index.
+//Index 0 is the empty mask. Masks are never changed or removed, so an index stays valid as long as the table does
+template <int R>
+class SearchMaskTable
+{
+public:
+    SearchMaskTable()
+        : m_masks(1)
+    {
+        m_indices[m_masks[0]] = 0;
+    }
+
+    const SearchMask<R>& operator[](int idx) const
+    {
+        return m_masks[idx];
+    }
+
+    //Index of this mask, adding it if it isn't in the table yet
+    int intern(const SearchMask<R>& mask)
+    {
+        auto [it, inserted] = m_indices.try_emplace(mask, m_masks.size());
+        if(inserted)
+        {
+            m_masks.push_back(mask);
+        }
+        return it->second;
+    }
+
+private:
+    struct Hash
+    {
+        size_t operator()(const SearchMask<R>& mask) const
+        {
+            return mask.hash();
+        }
+    };
+
+    std::vector<SearchMask<R>> m_masks;
+    std::unordered_map<SearchMask<R>, int, Hash> m_indices;
+};
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef __TRIG_TABLES_HH__
+#define __TRIG_TABLES_HH__
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+//Trig for the simulation that gives the same bits on every compiler, optimization level and libm.
+//The tables are worked out at compile time with plain double arithmetic, and lookups only use integer math
+//apart from converting in and out, so nothing is left for the compiler or the platform to do differently.
+//Angles are in degrees, like everywhere else in the game.
+namespace trig{
+    //A full turn is 2^32, so angles wrap around with plain integer overflow
+    typedef uint32_t turn_t;
+
+    constexpr int64_t FULL_TURN = int64_t(1) << 32;
+    constexpr int64_t HALF_TURN = int64_t(1) << 31;
+    constexpr int64_t QUARTER_TURN = int64_t(1) << 30;
+
+    //Sines for a full turn, 2^SIN_BITS steps, as fixed point with SIN_ONE_BITS fraction bits
+    constexpr int SIN_BITS = 12;
+    constexpr int SIN_STEPS = 1 << SIN_BITS;
+    constexpr int SIN_ONE_BITS = 30;
+
+    //Arctangents of ratios from 0 to 1 in 2^ATAN_BITS steps, in turn_t units
+    constexpr int ATAN_BITS = 10;
+    constexpr int ATAN_STEPS = 1 << ATAN_BITS;
+    //Fraction bits of the ratio being looked up
+    constexpr int RATIO_BITS = 30;
+
+    namespace detail{
+        constexpr double PI = 3.14159265358979323846;
+
+        //Taylor series, only used for |x| <= pi/4 where they converge well before the last term
+        constexpr double sinSeries(double x)
+        {
+            double term = x;
+            double sum = x;
+            for(int n = 1; n < 12; n++)
+            {
+                term *= -x * x / ((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr double cosSeries(double x)
+        {
+            double term = 1;
+            double sum = 1;
+            for(int n = 1; n < 12; n++)
+            {
+                term *= -x * x / ((2 * n - 1) * (2 * n));
+                sum += term;
+            }
+            return sum;
+        }
+
+        //Only used for |x| <= sqrt(2) - 1
+        constexpr double atanSeries(double x)
+        {
+            double power = x;
+            double sum = x;
+            for(int n = 1; n < 30; n++)
+            {
+                power *= -x * x;
+                sum += power / (2 * n + 1);
+            }
+            return sum;
+        }
+
+        //sin(2 pi * step / SIN_STEPS) for steps in the first quarter turn
+        constexpr double quarterSin(int step)
+        {
+            if(step <= SIN_STEPS / 8)
+            {
+                return sinSeries(2 * PI * step / SIN_STEPS);
+            }
+            return cosSeries(2 * PI * (SIN_STEPS / 4 - step) / SIN_STEPS);
+        }
+
+        constexpr int64_t roundToInt(double value)
+        {
+            return value >= 0 ? int64_t(value + 0.5) : -int64_t(-value + 0.5);
+        }
+
+        //One extra entry at the end so that lookups never need to wrap
+        constexpr std::array<int32_t, SIN_STEPS + 1> makeSinTable()
+        {
+            std::array<int32_t, SIN_STEPS + 1> table{};
+            const int quarter = SIN_STEPS / 4;
+            for(int step = 0; step <= SIN_STEPS; step++)
+            {
+                int inQuarter = step % quarter;
+                double value = 0;
+                switch((step / quarter) % 4)
+                {
+                    case 0: value = quarterSin(inQuarter); break;
+                    case 1: value = quarterSin(quarter - inQuarter); break;
+                    case 2: value = -quarterSin(inQuarter); break;
+                    case 3: value = -quarterSin(quarter - inQuarter); break;
+                }
+                table[step] = roundToInt(value * (int64_t(1) << SIN_ONE_BITS));
+            }
+            return table;
+        }
+
+        constexpr std::array<int32_t, ATAN_STEPS + 1> makeAtanTable()
+        {
+            std::array<int32_t, ATAN_STEPS + 1> table{};
+            for(int step = 0; step <= ATAN_STEPS; step++)
+            {
+                double ratio = double(step) / ATAN_STEPS;
+                //atan(r) = pi/4 + atan((r - 1) / (r + 1)) keeps the series argument small
+                double value = ratio <= 0.41421356 ? atanSeries(ratio) : PI / 4 + atanSeries((ratio - 1) / (ratio + 1));
+                table[step] = roundToInt(value / (2 * PI) * FULL_TURN);
+            }
+            return table;
+        }
+
+        constexpr std::array<int32_t, SIN_STEPS + 1> SIN_TABLE = makeSinTable();
+        constexpr std::array<int32_t, ATAN_STEPS + 1> ATAN_TABLE = makeAtanTable();
+    }//end namespace detail
+
+    static turn_t degreesToTurn(float angle_deg)
+    {
+        //Anything this big has lost all its precision anyway, and wouldn't fit in an int64_t
+        if(!(std::abs(angle_deg) < 1e11f))
+        {
+            return 0;
+        }
+        return turn_t(int64_t(double(angle_deg) * (double(FULL_TURN) / 360.0)));
+    }
+
+    static float turnToDegrees(int64_t angle)
+    {
+        return float(angle) * float(360.0 / FULL_TURN);
+    }
+
+    static float sinTurn(turn_t angle)
+    {
+        //Linear interpolation between table entries, with 16 bits of the angle left over for the fraction
+        int step = angle >> (32 - SIN_BITS);
+        int64_t fraction = (angle >> (16 - SIN_BITS)) & 0xFFFF;
+        int64_t low = detail::SIN_TABLE[step];
+        int64_t high = detail::SIN_TABLE[step + 1];
+        int64_t value = low + (((high - low) * fraction) >> 16);
+        return float(value) * (1.0f / (int64_t(1) << SIN_ONE_BITS));
+    }
+
+    static float sinDeg(float angle_deg)
+    {
+        return sinTurn(degreesToTurn(angle_deg));
+    }
+
+    static float cosDeg(float angle_deg)
+    {
+        return sinTurn(degreesToTurn(angle_deg) + turn_t(QUARTER_TURN));
+    }
+
+    //Angle of (x, y) from the positive x axis, in (-180, 180]. Zero for (0, 0)
+    static float atan2Deg(float y, float x)
+    {
+        if(x == 0 && y == 0)
+        {
+            return 0;
+        }
+
+        //Work with the smaller of the two over the larger, then put the octant back afterwards
+        float absX = std::abs(x);
+        float absY = std::abs(y);
+        bool steep = absY > absX;
+        float num = steep ? absX : absY;
+        float den = steep ? absY : absX;
+
+        //Scaling by a power of two is exact, so the ratio can be taken with integers
+        int exponent;
+        std::frexp(den, &exponent);
+        int64_t scaledNum = int64_t(std::ldexp(num, 32 - exponent));
+        int64_t scaledDen = int64_t(std::ldexp(den, 32 - exponent));
+        int64_t ratio = (scaledNum << RATIO_BITS) / scaledDen;
+
+        int step = ratio >> (RATIO_BITS - ATAN_BITS);
+        int64_t fraction = ratio & ((1 << (RATIO_BITS - ATAN_BITS)) - 1);
+        int64_t low = detail::ATAN_TABLE[step];
+        int64_t high = step < ATAN_STEPS ? detail::ATAN_TABLE[step + 1] : low;
+        int64_t angle = low + (((high - low) * fraction) >> (RATIO_BITS - ATAN_BITS));
+
+        if(steep)
+        {
+            angle = QUARTER_TURN - angle;
+        }
+        if(x < 0)
+        {
+            angle = HALF_TURN - angle;
+        }
+        if(y < 0)
+        {
+            angle = -angle;
+        }
+        return turnToDegrees(angle);
+    }
+}//end namespace trig
+
+#endif